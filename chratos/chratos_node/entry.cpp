@@ -22,16 +22,25 @@ int main (int argc, char * const * argv)
 		("debug_bootstrap_generate", "Generate bootstrap sequence of blocks")
 		("debug_dump_representatives", "List representatives and weights")
 		("debug_account_count", "Display the number of accounts")
+		("debug_validate_ledger", "Recompute ledger totals and invariants and report mismatches")
 		("debug_mass_activity", "Generates fake debug activity")
+		("debug_generate_ledger", "Write a deterministic test network ledger of <accounts> straight into the data directory")
 		("debug_profile_generate", "Profile work generation")
 		("debug_opencl", "OpenCL work generation")
 		("debug_profile_verify", "Profile work verification")
 		("debug_profile_kdf", "Profile kdf function")
 		("debug_verify_profile", "Profile signature verification")
 		("debug_profile_sign", "Profile signature generation")
+		("debug_profile_votes", "Profile vote signing with raw and expanded keys")
 		("platform", boost::program_options::value<std::string> (), "Defines the <platform> for OpenCL commands")
 		("device", boost::program_options::value<std::string> (), "Defines <device> for OpenCL command")
-		("threads", boost::program_options::value<std::string> (), "Defines <threads> count for OpenCL command");
+		("threads", boost::program_options::value<std::string> (), "Defines <threads> count for OpenCL, ledger generation and ledger validation commands")
+		("accounts", boost::program_options::value<uint64_t> ()->default_value (1000), "Defines <accounts> to generate")
+		("chain_length", boost::program_options::value<uint64_t> ()->default_value (4), "Defines the mean <chain_length> of generated accounts")
+		("dividend_interval", boost::program_options::value<uint64_t> ()->default_value (0), "Defines how many accounts are generated between dividends, 0 for none")
+		("claim_ratio", boost::program_options::value<double> ()->default_value (0.5), "Defines the fraction of generated accounts that claim dividends")
+		("batch_size", boost::program_options::value<uint64_t> ()->default_value (64 * 1024), "Defines the number of blocks written per transaction")
+		("seed", boost::program_options::value<uint64_t> ()->default_value (0), "Defines the <seed> for generated keys and activity");
 	// clang-format on
 
 	boost::program_options::variables_map vm;
@@ -150,12 +159,311 @@ int main (int argc, char * const * argv)
 			chratos::transaction transaction (node.node->store.environment, nullptr, false);
 			std::cout << boost::str (boost::format ("Frontier count: %1%\n") % node.node->store.account_count (transaction));
 		}
+		else if (vm.count ("debug_validate_ledger"))
+		{
+			chratos::inactive_node node (data_path);
+			auto & store (node.node->store);
+			auto & ledger (node.node->ledger);
+			unsigned threads (std::max (1u, std::thread::hardware_concurrency ()));
+			if (vm.count ("threads") == 1)
+			{
+				try
+				{
+					threads = std::max (1u, boost::lexical_cast<unsigned> (vm["threads"].as<std::string> ()));
+				}
+				catch (boost::bad_lexical_cast & e)
+				{
+					std::cerr << "Invalid threads count\n";
+					result = -1;
+				}
+			}
+			if (!result)
+			{
+				std::mutex mutex;
+				uint64_t mismatches (0);
+				auto report ([&mutex, &mismatches](std::string const & message_a) {
+					std::lock_guard<std::mutex> lock (mutex);
+					++mismatches;
+					std::cerr << message_a << std::endl;
+				});
+				// Rank every dividend from the base so ordering checks don't have to walk the dividend chain per block
+				std::unordered_map<chratos::block_hash, uint64_t> dividends;
+				chratos::checksum stored_checksum (0);
+				{
+					chratos::transaction transaction (store.environment, nullptr, false);
+					std::vector<chratos::block_hash> chain;
+					for (auto dividend (store.dividend_get (transaction).head); dividend != chratos::dividend_base;)
+					{
+						auto block (store.block_get (transaction, dividend));
+						if (block == nullptr || block->type () != chratos::block_type::dividend)
+						{
+							report (boost::str (boost::format ("Dividend chain broken at %1%") % dividend.to_string ()));
+							break;
+						}
+						chain.push_back (dividend);
+						dividend = block->dividend ();
+					}
+					dividends[chratos::dividend_base] = 0;
+					for (size_t i (0), n (chain.size ()); i < n; ++i)
+					{
+						dividends[chain[n - i - 1]] = i + 1;
+					}
+					if (store.checksum_get (transaction, 0, 0, stored_checksum))
+					{
+						report ("Ledger checksum missing");
+					}
+				}
+				class totals
+				{
+				public:
+					uint64_t accounts = 0;
+					uint64_t blocks = 0;
+					uint64_t pending = 0;
+					chratos::uint128_t balance = 0;
+					chratos::uint128_t pending_amount = 0;
+					chratos::checksum checksum = 0;
+					std::unordered_map<chratos::account, chratos::uint128_t> weights;
+				};
+				// Accounts and pending entries are sharded by the leading byte of the account and handed out on demand.
+				// Each worker opens its own read transaction; nothing writes to an inactive node so they all see the same snapshot.
+				std::vector<totals> shards (threads);
+				std::atomic<unsigned> next_shard (0);
+				auto validate ([&](totals & totals_a) {
+					chratos::transaction transaction (store.environment, nullptr, false);
+					for (auto shard (next_shard++); shard < 256; shard = next_shard++)
+					{
+						chratos::account begin (0);
+						begin.bytes[0] = shard;
+						chratos::account end (0);
+						end.bytes[0] = shard + 1;
+						auto last (shard == 255);
+						for (auto i (store.latest_begin (transaction, begin)), n (store.latest_end ()); i != n && (last || chratos::account (i->first) < end); ++i)
+						{
+							chratos::account account (i->first);
+							chratos::account_info info (i->second);
+							++totals_a.accounts;
+							totals_a.balance += info.balance.number ();
+							totals_a.checksum ^= info.head;
+							auto account_dividend (dividends.find (info.dividend_block));
+							if (account_dividend == dividends.end ())
+							{
+								report (boost::str (boost::format ("Account %1% has unknown dividend %2%") % account.to_account () % info.dividend_block.to_string ()));
+							}
+							auto account_rank (account_dividend != dividends.end () ? account_dividend->second : std::numeric_limits<uint64_t>::max ());
+							auto claim_rank (std::numeric_limits<uint64_t>::max ());
+							// The dividend account issues the dividends its blocks reference, so it's checked against the dividend chain order instead
+							auto issuer (account == chratos::dividend_account);
+							auto issued_rank (std::numeric_limits<uint64_t>::max ());
+							uint64_t block_count (0);
+							chratos::block_hash open (0);
+							for (auto hash (info.head); !hash.is_zero ();)
+							{
+								auto block (store.block_get (transaction, hash));
+								if (block == nullptr)
+								{
+									report (boost::str (boost::format ("Account %1% missing block %2%") % account.to_account () % hash.to_string ()));
+									break;
+								}
+								++block_count;
+								auto rank (dividends.find (block->dividend ()));
+								if (rank == dividends.end ())
+								{
+									report (boost::str (boost::format ("Block %1% references unknown dividend %2%") % hash.to_string () % block->dividend ().to_string ()));
+								}
+								else
+								{
+									if (issuer)
+									{
+										if (block->type () == chratos::block_type::dividend)
+										{
+											auto issued (dividends.find (hash));
+											if (issued == dividends.end ())
+											{
+												report (boost::str (boost::format ("Dividend %1% isn't in the dividend chain") % hash.to_string ()));
+											}
+											else if (issued->second >= issued_rank)
+											{
+												report (boost::str (boost::format ("Dividend %1% is out of order in account %2%") % hash.to_string () % account.to_account ()));
+											}
+											else
+											{
+												issued_rank = issued->second;
+											}
+										}
+									}
+									else if (rank->second > account_rank)
+									{
+										report (boost::str (boost::format ("Block %1% is ahead of the dividend of account %2%") % hash.to_string () % account.to_account ()));
+									}
+									auto claim (block->type () == chratos::block_type::claim);
+									if (!claim && block->type () == chratos::block_type::state)
+									{
+										claim = ledger.is_dividend_claim (transaction, *static_cast<chratos::state_block *> (block.get ()));
+									}
+									if (claim)
+									{
+										if (rank->second >= claim_rank)
+										{
+											report (boost::str (boost::format ("Claim %1% of account %2% is out of dividend order") % hash.to_string () % account.to_account ()));
+										}
+										claim_rank = rank->second;
+									}
+								}
+								open = hash;
+								hash = block->previous ();
+							}
+							totals_a.blocks += block_count;
+							if (block_count != info.block_count)
+							{
+								report (boost::str (boost::format ("Account %1% block count %2% but chain has %3%") % account.to_account () % info.block_count % block_count));
+							}
+							if (open != info.open_block)
+							{
+								report (boost::str (boost::format ("Account %1% open block %2% but chain starts at %3%") % account.to_account () % info.open_block.to_string () % open.to_string ()));
+							}
+							if (ledger.balance (transaction, info.head) != info.balance.number ())
+							{
+								report (boost::str (boost::format ("Account %1% balance differs from head block %2%") % account.to_account () % info.head.to_string ()));
+							}
+							auto rep_block (store.block_get (transaction, info.rep_block));
+							if (rep_block == nullptr)
+							{
+								report (boost::str (boost::format ("Account %1% missing representative block %2%") % account.to_account () % info.rep_block.to_string ()));
+							}
+							else
+							{
+								totals_a.weights[rep_block->representative ()] += info.balance.number ();
+							}
+						}
+						for (auto i (store.pending_begin (transaction, chratos::pending_key (begin, 0))), n (store.pending_end ()); i != n && (last || chratos::pending_key (i->first).account < end); ++i)
+						{
+							chratos::pending_key key (i->first);
+							chratos::pending_info pending (i->second);
+							++totals_a.pending;
+							totals_a.pending_amount += pending.amount.number ();
+							if (!store.block_exists (transaction, key.hash))
+							{
+								report (boost::str (boost::format ("Pending %1% for %2% has no source block") % key.hash.to_string () % key.account.to_account ()));
+							}
+							if (dividends.find (pending.dividend) == dividends.end ())
+							{
+								report (boost::str (boost::format ("Pending %1% references unknown dividend %2%") % key.hash.to_string () % pending.dividend.to_string ()));
+							}
+						}
+					}
+				});
+				auto begin (std::chrono::steady_clock::now ());
+				std::vector<std::thread> workers;
+				for (unsigned i (1); i < threads; ++i)
+				{
+					workers.emplace_back ([&validate, &shards, i]() { validate (shards[i]); });
+				}
+				validate (shards[0]);
+				for (auto & worker : workers)
+				{
+					worker.join ();
+				}
+				auto end (std::chrono::steady_clock::now ());
+				totals total;
+				for (auto & shard : shards)
+				{
+					total.accounts += shard.accounts;
+					total.blocks += shard.blocks;
+					total.pending += shard.pending;
+					total.balance += shard.balance;
+					total.pending_amount += shard.pending_amount;
+					total.checksum ^= shard.checksum;
+					for (auto & weight : shard.weights)
+					{
+						total.weights[weight.first] += weight.second;
+					}
+				}
+				if (total.checksum != stored_checksum)
+				{
+					report (boost::str (boost::format ("Ledger checksum %1% but account heads give %2%") % stored_checksum.to_string () % total.checksum.to_string ()));
+				}
+				{
+					chratos::transaction transaction (store.environment, nullptr, false);
+					for (auto i (store.representation_begin (transaction)), n (store.representation_end ()); i != n; ++i)
+					{
+						chratos::account representative (i->first);
+						auto stored (store.representation_get (transaction, representative));
+						auto existing (total.weights.find (representative));
+						auto calculated (existing != total.weights.end () ? existing->second : chratos::uint128_t (0));
+						if (stored != calculated)
+						{
+							report (boost::str (boost::format ("Representative %1% weight %2% but balances give %3%") % representative.to_account () % stored.convert_to<std::string> () % calculated.convert_to<std::string> ()));
+						}
+						if (existing != total.weights.end ())
+						{
+							total.weights.erase (existing);
+						}
+					}
+				}
+				for (auto & weight : total.weights)
+				{
+					if (!weight.second.is_zero ())
+					{
+						report (boost::str (boost::format ("Representative %1% has no weight entry but balances give %2%") % weight.first.to_account () % weight.second.convert_to<std::string> ()));
+					}
+				}
+				auto elapsed (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::milliseconds> (end - begin).count ()));
+				std::cout << boost::str (boost::format ("Accounts: %1%\nBlocks: %2%\nPending: %3%\nBalance: %4%\nPending amount: %5%\nDividends: %6%\n") % total.accounts % total.blocks % total.pending % total.balance.convert_to<std::string> () % total.pending_amount.convert_to<std::string> () % (dividends.size () - 1));
+				std::cout << boost::str (boost::format ("Validated in %1% ms on %2% threads, %3% accounts/s\nMismatches: %4%\n") % elapsed % threads % (total.accounts * 1000 / elapsed) % mismatches);
+				if (mismatches != 0)
+				{
+					result = -1;
+				}
+			}
+		}
 		else if (vm.count ("debug_mass_activity"))
 		{
 			chratos::system system (24000, 1);
 			size_t count (1000000);
 			system.generate_mass_activity (count, *system.nodes[0]);
 		}
+		else if (vm.count ("debug_generate_ledger"))
+		{
+			chratos::ledger_generator_config config;
+			config.accounts = vm["accounts"].as<uint64_t> ();
+			config.chain_length = vm["chain_length"].as<uint64_t> ();
+			config.dividend_interval = vm["dividend_interval"].as<uint64_t> ();
+			config.claim_ratio = vm["claim_ratio"].as<double> ();
+			config.batch_size = vm["batch_size"].as<uint64_t> ();
+			config.seed = vm["seed"].as<uint64_t> ();
+			config.threads = std::max (1u, std::thread::hardware_concurrency ());
+			if (vm.count ("threads") == 1)
+			{
+				try
+				{
+					config.threads = boost::lexical_cast<unsigned> (vm["threads"].as<std::string> ());
+				}
+				catch (boost::bad_lexical_cast & e)
+				{
+					std::cerr << "Invalid threads count\n";
+					result = -1;
+				}
+			}
+			if (!result)
+			{
+				chratos::inactive_node node (data_path);
+				chratos::ledger_generator generator (node.node->ledger, config);
+				auto begin (std::chrono::steady_clock::now ());
+				auto error (generator.generate ());
+				auto end (std::chrono::steady_clock::now ());
+				auto elapsed (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::milliseconds> (end - begin).count ()));
+				chratos::checksum checksum (0);
+				{
+					chratos::transaction transaction (node.node->store.environment, nullptr, false);
+					node.node->store.checksum_get (transaction, 0, 0, checksum);
+				}
+				std::cout << boost::str (boost::format ("Accounts: %1%\nBlocks: %2%\nDividends: %3%\nClaims: %4%\nChecksum: %5%\nGenerated in %6% ms, %7% blocks/s\n") % generator.accounts % generator.blocks % generator.dividends % generator.claims % checksum.to_string () % elapsed % (generator.blocks * 1000 / elapsed));
+				if (error)
+				{
+					result = -1;
+				}
+			}
+		}
 		else if (vm.count ("debug_profile_kdf"))
 		{
 			chratos::uint256_union result;
@@ -325,6 +633,27 @@ int main (int argc, char * const * argv)
 				std::cerr << boost::str (boost::format ("%|1$ 12d|\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
 			}
 		}
+		else if (vm.count ("debug_profile_votes"))
+		{
+			chratos::keypair key;
+			chratos::expanded_key expanded (key.prv);
+			std::vector<chratos::block_hash> hashes (12);
+			size_t const count (10000);
+			auto begin1 (std::chrono::high_resolution_clock::now ());
+			for (uint64_t i (0); i < count; ++i)
+			{
+				chratos::vote vote (key.pub, key.prv, i, hashes);
+			}
+			auto end1 (std::chrono::high_resolution_clock::now ());
+			for (uint64_t i (0); i < count; ++i)
+			{
+				chratos::vote vote (key.pub, expanded, i, hashes);
+			}
+			auto end2 (std::chrono::high_resolution_clock::now ());
+			auto raw_us (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ()));
+			auto expanded_us (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::microseconds> (end2 - end1).count ()));
+			std::cerr << boost::str (boost::format ("Raw key: %1% votes/s\nExpanded key: %2% votes/s\n") % (count * 1000000 / raw_us) % (count * 1000000 / expanded_us));
+		}
 		else if (vm.count ("version"))
 		{
 			std::cout << "Version " << RAIBLOCKS_VERSION_MAJOR << "." << RAIBLOCKS_VERSION_MINOR << std::endl;
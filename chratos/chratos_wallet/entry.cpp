@@ -234,6 +234,8 @@ int run_wallet (QApplication & application, int argc, char * const * argv, boost
 					wallet = node->wallets.create (config.wallet);
 				}
 			}
+			// Wallets loaded from disk stay locked until node::start queues the initial unlock, this one is needed now
+			wallet->enter_initial_password ();
 			if (config.account.is_zero () || !wallet->exists (config.account))
 			{
 				chratos::transaction transaction (wallet->store.environment, nullptr, true);
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <chratos/node/stats.hpp>
+#include <chratos/secure/blockstore.hpp>
+#include <chratos/secure/ledger.hpp>
+#include <chratos/secure/utility.hpp>
+
+TEST (ledger, confirm_receive_cements_source)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, open1).code);
+	chratos::state_block send2 (key1.pub, open1.hash (), key1.pub, 60, chratos::test_genesis_key.pub, chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send2).code);
+	ASSERT_EQ (1u, ledger.confirmation_height (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (0u, ledger.confirmation_height (transaction, key1.pub));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, genesis.hash ()));
+	ASSERT_EQ (chratos::confirmation_status::unconfirmed, ledger.block_confirmed (transaction, send1.hash ()));
+	ASSERT_EQ (chratos::confirmation_status::unconfirmed, ledger.block_confirmed (transaction, send2.hash ()));
+	chratos::confirmation_job job (send2.hash ());
+	ledger.confirm (transaction, job, 1024);
+	ASSERT_TRUE (job.done ());
+	// The open block receives send1, so send1 had to be cemented first
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, key1.pub));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, send1.hash ()));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, open1.hash ()));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, send2.hash ()));
+	chratos::state_block receive2 (chratos::test_genesis_key.pub, send1.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 60, send2.hash (), chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, receive2).code);
+	ASSERT_EQ (chratos::confirmation_status::unconfirmed, ledger.block_confirmed (transaction, receive2.hash ()));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, send1.hash ()));
+}
+
+TEST (ledger, confirm_in_steps)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, open1).code);
+	chratos::state_block send2 (key1.pub, open1.hash (), key1.pub, 60, chratos::test_genesis_key.pub, chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send2).code);
+	chratos::confirmation_job job (send2.hash ());
+	auto rounds (0);
+	while (!job.done ())
+	{
+		ledger.confirm (transaction, job, 1);
+		++rounds;
+		ASSERT_LT (rounds, 100);
+	}
+	ASSERT_GT (rounds, 1);
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, key1.pub));
+	// Confirming an already cemented block is a no-op
+	chratos::confirmation_job job2 (open1.hash ());
+	ledger.confirm (transaction, job2, 1024);
+	ASSERT_TRUE (job2.done ());
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, key1.pub));
+}
+
+TEST (ledger, block_confirmed_walk_limit)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	std::vector<chratos::block_hash> chain;
+	auto previous (genesis.hash ());
+	for (size_t i (0); i < chratos::ledger::confirmation_walk_max + 16; ++i)
+	{
+		chratos::state_block change (chratos::test_genesis_key.pub, previous, chratos::test_genesis_key.pub, chratos::genesis_amount, 0, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+		ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, change).code);
+		previous = change.hash ();
+		chain.push_back (previous);
+	}
+	ASSERT_EQ (chratos::confirmation_status::unconfirmed, ledger.block_confirmed (transaction, chain.front ()));
+	// The head is further than the walk limit from the confirmed frontier
+	ASSERT_EQ (chratos::confirmation_status::unknown, ledger.block_confirmed (transaction, chain.back ()));
+	chratos::confirmation_job job (chain.back ());
+	while (!job.done ())
+	{
+		ledger.confirm (transaction, job, 256);
+	}
+	ASSERT_EQ (chain.size () + 1, ledger.confirmation_height (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, chain.front ()));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, chain.back ()));
+}
+
+TEST (ledger, rollback_pending_send)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	ASSERT_TRUE (store.pending_exists (transaction, chratos::pending_key (key1.pub, send1.hash ())));
+	ledger.rollback (transaction, send1.hash ());
+	ASSERT_FALSE (store.block_exists (transaction, send1.hash ()));
+	ASSERT_FALSE (store.pending_exists (transaction, chratos::pending_key (key1.pub, send1.hash ())));
+	ASSERT_EQ (genesis.hash (), ledger.latest (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::genesis_amount, ledger.account_balance (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::genesis_amount, ledger.weight (transaction, chratos::test_genesis_key.pub));
+}
+
+TEST (ledger, rollback_received_send)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, open1).code);
+	chratos::state_block send2 (key1.pub, open1.hash (), key1.pub, 60, chratos::test_genesis_key.pub, chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send2).code);
+	chratos::state_block receive2 (chratos::test_genesis_key.pub, send1.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 60, send2.hash (), chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, receive2).code);
+	ASSERT_EQ (chratos::genesis_amount - 60, ledger.weight (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (60, ledger.weight (transaction, key1.pub));
+	// send1 was received by key1, whose send2 was received back by the genesis account, so everything goes
+	ledger.rollback (transaction, send1.hash ());
+	ASSERT_FALSE (store.block_exists (transaction, send1.hash ()));
+	ASSERT_FALSE (store.block_exists (transaction, open1.hash ()));
+	ASSERT_FALSE (store.block_exists (transaction, send2.hash ()));
+	ASSERT_FALSE (store.block_exists (transaction, receive2.hash ()));
+	ASSERT_FALSE (store.account_exists (transaction, key1.pub));
+	ASSERT_FALSE (store.pending_exists (transaction, chratos::pending_key (key1.pub, send1.hash ())));
+	ASSERT_FALSE (store.pending_exists (transaction, chratos::pending_key (chratos::test_genesis_key.pub, send2.hash ())));
+	ASSERT_EQ (genesis.hash (), ledger.latest (transaction, chratos::test_genesis_key.pub));
+	ASSERT_TRUE (store.block_successor (transaction, genesis.hash ()).is_zero ());
+	ASSERT_EQ (chratos::genesis_amount, ledger.account_balance (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::genesis_amount, ledger.weight (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (0, ledger.weight (transaction, key1.pub));
+}
+
+TEST (ledger, rollback_receive_restores_pending)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, open1).code);
+	ledger.rollback (transaction, open1.hash ());
+	ASSERT_FALSE (store.block_exists (transaction, open1.hash ()));
+	ASSERT_TRUE (store.block_exists (transaction, send1.hash ()));
+	ASSERT_FALSE (store.account_exists (transaction, key1.pub));
+	chratos::pending_info pending;
+	ASSERT_FALSE (store.pending_get (transaction, chratos::pending_key (key1.pub, send1.hash ()), pending));
+	ASSERT_EQ (chratos::test_genesis_key.pub, pending.source);
+	ASSERT_EQ (100, pending.amount.number ());
+	ASSERT_EQ (0, ledger.weight (transaction, key1.pub));
+}
+
+TEST (ledger, rollback_cemented)
+{
+	bool init (false);
+	chratos::block_store store (init, chratos::unique_path ());
+	ASSERT_FALSE (init);
+	chratos::stat stats;
+	chratos::ledger ledger (store, stats);
+	chratos::genesis genesis;
+	chratos::transaction transaction (store.environment, nullptr, true);
+	store.initialize (transaction, genesis);
+	chratos::keypair key1;
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, ledger.process (transaction, open1).code);
+	chratos::confirmation_job job (open1.hash ());
+	ledger.confirm (transaction, job, 1024);
+	ASSERT_TRUE (job.done ());
+	ASSERT_EQ (2u, ledger.confirmation_height (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (1u, ledger.confirmation_height (transaction, key1.pub));
+	ledger.rollback (transaction, send1.hash ());
+	// The confirmed frontier moves back onto what's left of the chain
+	chratos::confirmation_height_info confirmed;
+	ASSERT_FALSE (store.confirmation_height_get (transaction, chratos::test_genesis_key.pub, confirmed));
+	ASSERT_EQ (1u, confirmed.height);
+	ASSERT_EQ (genesis.hash (), confirmed.frontier);
+	ASSERT_EQ (0u, ledger.confirmation_height (transaction, key1.pub));
+	ASSERT_EQ (chratos::confirmation_status::confirmed, ledger.block_confirmed (transaction, genesis.hash ()));
+}
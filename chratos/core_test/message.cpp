@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <chratos/node/common.hpp>
+
+namespace
+{
+std::vector<uint8_t> encode_delta (chratos::block const & block_a, chratos::block const * reference_a)
+{
+	std::vector<uint8_t> result;
+	{
+		chratos::vectorstream stream (result);
+		chratos::serialize_block_delta (stream, block_a, reference_a);
+	}
+	return result;
+}
+
+std::unique_ptr<chratos::block> decode_delta (std::vector<uint8_t> const & bytes_a, chratos::block const * reference_a)
+{
+	chratos::bufferstream stream (bytes_a.data (), bytes_a.size ());
+	uint8_t header;
+	auto error (chratos::read (stream, header));
+	EXPECT_FALSE (error);
+	EXPECT_EQ (bytes_a.size () - 1, chratos::block_delta_size (header));
+	return chratos::deserialize_block_delta (stream, header, reference_a);
+}
+}
+
+TEST (message, bulk_pull_delta_flag)
+{
+	chratos::bulk_pull message;
+	message.start = 1;
+	message.end = 2;
+	ASSERT_FALSE (message.delta ());
+	message.delta_set (true);
+	std::vector<uint8_t> bytes;
+	{
+		chratos::vectorstream stream (bytes);
+		message.serialize (stream);
+	}
+	chratos::bufferstream stream (bytes.data (), bytes.size ());
+	auto error (false);
+	chratos::message_header header (error, stream);
+	ASSERT_FALSE (error);
+	chratos::bulk_pull message2 (error, stream, header);
+	ASSERT_FALSE (error);
+	ASSERT_TRUE (message2.delta ());
+	ASSERT_EQ (message.start, message2.start);
+	ASSERT_EQ (message.end, message2.end);
+}
+
+TEST (message, bulk_pull_delta_chain)
+{
+	chratos::keypair key;
+	chratos::state_block open (key.pub, 0, key.pub, 100, 1, 2, key.prv, key.pub, 3);
+	chratos::state_block send (key.pub, open.hash (), key.pub, 50, 4, 2, key.prv, key.pub, 5);
+	std::vector<uint8_t> full;
+	{
+		chratos::vectorstream stream (full);
+		send.serialize (stream);
+	}
+	// The first block in a stream has nothing to refer to, only its zero previous is left out
+	auto open_bytes (encode_delta (open, nullptr));
+	auto open2 (decode_delta (open_bytes, nullptr));
+	ASSERT_NE (nullptr, open2);
+	ASSERT_EQ (open, *open2);
+	auto send_bytes (encode_delta (send, &open));
+	ASSERT_EQ (1 + full.size () - 3 * sizeof (chratos::uint256_union), send_bytes.size ());
+	auto send2 (decode_delta (send_bytes, open2.get ()));
+	ASSERT_NE (nullptr, send2);
+	ASSERT_EQ (send, *send2);
+	ASSERT_EQ (send.hash (), send2->hash ());
+}
+
+TEST (message, bulk_pull_delta_different_fields)
+{
+	chratos::keypair key1;
+	chratos::keypair key2;
+	chratos::state_block block1 (key1.pub, 1, key1.pub, 100, 1, 2, key1.prv, key1.pub, 3);
+	chratos::state_block block2 (key2.pub, 4, key1.pub, 50, 5, 6, key2.prv, key2.pub, 7);
+	auto bytes (encode_delta (block2, &block1));
+	auto block3 (decode_delta (bytes, &block1));
+	ASSERT_NE (nullptr, block3);
+	ASSERT_EQ (block2, *block3);
+}
+
+TEST (message, bulk_pull_delta_dividend)
+{
+	chratos::keypair key;
+	chratos::state_block previous (key.pub, 1, key.pub, 100, 1, 2, key.prv, key.pub, 3);
+	chratos::dividend_block dividend (key.pub, previous.hash (), key.pub, 50, 2, key.prv, key.pub, 4);
+	auto bytes (encode_delta (dividend, &previous));
+	auto dividend2 (decode_delta (bytes, &previous));
+	ASSERT_NE (nullptr, dividend2);
+	ASSERT_EQ (chratos::block_type::dividend, dividend2->type ());
+	ASSERT_EQ (dividend, *dividend2);
+}
+
+TEST (message, bulk_pull_delta_missing_reference)
+{
+	chratos::keypair key;
+	chratos::state_block block1 (key.pub, 1, key.pub, 100, 1, 2, key.prv, key.pub, 3);
+	chratos::state_block block2 (key.pub, block1.hash (), key.pub, 50, 4, 2, key.prv, key.pub, 5);
+	auto bytes (encode_delta (block2, &block1));
+	chratos::bufferstream stream (bytes.data (), bytes.size ());
+	uint8_t header;
+	ASSERT_FALSE (chratos::read (stream, header));
+	// Omitted fields can't be filled back in without the block sent before it
+	ASSERT_EQ (nullptr, chratos::deserialize_block_delta (stream, header, nullptr));
+}
+
+TEST (message, bulk_pull_delta_invalid_header)
+{
+	ASSERT_EQ (0u, chratos::block_delta_size (static_cast<uint8_t> (chratos::block_type::state)));
+	ASSERT_EQ (0u, chratos::block_delta_size (chratos::bulk_pull::delta_marker | static_cast<uint8_t> (chratos::block_type::invalid)));
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <chratos/core_test/testutil.hpp>
+#include <chratos/node/testing.hpp>
+
+#include <thread>
+
+TEST (vote_reuse, find_insert)
+{
+	chratos::vote_reuse reuse (std::chrono::milliseconds (5000));
+	chratos::keypair key1;
+	chratos::keypair key2;
+	chratos::block_hash hash (42);
+	std::shared_ptr<chratos::vote> vote;
+	std::shared_ptr<std::vector<uint8_t>> bytes;
+	ASSERT_TRUE (reuse.find (key1.pub, hash, vote, bytes));
+	auto vote1 (std::make_shared<chratos::vote> (key1.pub, key1.prv, 1, std::vector<chratos::block_hash>{ hash }));
+	auto bytes1 (std::make_shared<std::vector<uint8_t>> (1, 1));
+	reuse.insert (vote1, bytes1);
+	ASSERT_FALSE (reuse.find (key1.pub, hash, vote, bytes));
+	ASSERT_EQ (vote1, vote);
+	ASSERT_EQ (bytes1, bytes);
+	// Keyed by representative as well as block
+	ASSERT_TRUE (reuse.find (key2.pub, hash, vote, bytes));
+	ASSERT_TRUE (reuse.find (key1.pub, chratos::block_hash (43), vote, bytes));
+	// A newer vote from the same representative replaces the old one
+	auto vote2 (std::make_shared<chratos::vote> (key1.pub, key1.prv, 2, std::vector<chratos::block_hash>{ hash }));
+	auto bytes2 (std::make_shared<std::vector<uint8_t>> (1, 2));
+	reuse.insert (vote2, bytes2);
+	ASSERT_EQ (1u, reuse.size ());
+	ASSERT_FALSE (reuse.find (key1.pub, hash, vote, bytes));
+	ASSERT_EQ (vote2, vote);
+	ASSERT_EQ (bytes2, bytes);
+}
+
+TEST (vote_reuse, single_block_only)
+{
+	chratos::vote_reuse reuse (std::chrono::milliseconds (5000));
+	chratos::keypair key1;
+	auto vote1 (std::make_shared<chratos::vote> (key1.pub, key1.prv, 1, std::vector<chratos::block_hash>{ chratos::block_hash (1), chratos::block_hash (2) }));
+	reuse.insert (vote1, std::make_shared<std::vector<uint8_t>> ());
+	ASSERT_EQ (0u, reuse.size ());
+}
+
+TEST (vote_reuse, expiry)
+{
+	chratos::vote_reuse reuse (std::chrono::milliseconds (10));
+	chratos::keypair key1;
+	chratos::block_hash hash (42);
+	reuse.insert (std::make_shared<chratos::vote> (key1.pub, key1.prv, 1, std::vector<chratos::block_hash>{ hash }), std::make_shared<std::vector<uint8_t>> ());
+	ASSERT_EQ (1u, reuse.size ());
+	std::this_thread::sleep_for (std::chrono::milliseconds (50));
+	std::shared_ptr<chratos::vote> vote;
+	std::shared_ptr<std::vector<uint8_t>> bytes;
+	ASSERT_TRUE (reuse.find (key1.pub, hash, vote, bytes));
+	ASSERT_EQ (0u, reuse.size ());
+}
+
+TEST (vote_reuse, disabled)
+{
+	chratos::vote_reuse reuse (std::chrono::milliseconds (0));
+	chratos::keypair key1;
+	chratos::block_hash hash (42);
+	reuse.insert (std::make_shared<chratos::vote> (key1.pub, key1.prv, 1, std::vector<chratos::block_hash>{ hash }), std::make_shared<std::vector<uint8_t>> ());
+	ASSERT_EQ (0u, reuse.size ());
+	std::shared_ptr<chratos::vote> vote;
+	std::shared_ptr<std::vector<uint8_t>> bytes;
+	ASSERT_TRUE (reuse.find (key1.pub, hash, vote, bytes));
+}
+
+TEST (node_config, v17_v18_upgrade)
+{
+	chratos::logging logging;
+	chratos::node_config config (24000, logging);
+	boost::property_tree::ptree tree;
+	config.serialize_json (tree);
+	ASSERT_EQ ("18", tree.get<std::string> ("version"));
+	tree.erase ("vote_reuse_window");
+	tree.erase ("version");
+	tree.put ("version", "17");
+	chratos::node_config config2;
+	bool upgraded (false);
+	ASSERT_FALSE (config2.deserialize_json (upgraded, tree));
+	ASSERT_TRUE (upgraded);
+	ASSERT_EQ ("18", tree.get<std::string> ("version"));
+	ASSERT_EQ ("5000", tree.get<std::string> ("vote_reuse_window"));
+	ASSERT_EQ (5000u, config2.vote_reuse_window);
+}
+
+TEST (node_config, vote_reuse_window_round_trip)
+{
+	chratos::logging logging;
+	chratos::node_config config (24000, logging);
+	config.vote_reuse_window = 0;
+	boost::property_tree::ptree tree;
+	config.serialize_json (tree);
+	chratos::node_config config2;
+	bool upgraded (false);
+	ASSERT_FALSE (config2.deserialize_json (upgraded, tree));
+	ASSERT_FALSE (upgraded);
+	ASSERT_EQ (0u, config2.vote_reuse_window);
+}
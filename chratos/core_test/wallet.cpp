@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <chratos/core_test/testutil.hpp>
+#include <chratos/node/testing.hpp>
+
+TEST (wallet, send_chain)
+{
+	chratos::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	system.wallet (0)->insert_adhoc (chratos::test_genesis_key.prv);
+	chratos::keypair key1;
+	chratos::keypair key2;
+	std::vector<std::pair<chratos::account, chratos::uint128_t>> destinations{ { key1.pub, 100 }, { key2.pub, 50 } };
+	auto blocks (system.wallet (0)->send_chain_action (chratos::test_genesis_key.pub, destinations));
+	ASSERT_EQ (2u, blocks.size ());
+	ASSERT_EQ (blocks[0]->hash (), blocks[1]->previous ());
+	chratos::transaction transaction (node.store.environment, nullptr, false);
+	ASSERT_EQ (blocks[1]->hash (), node.ledger.latest (transaction, chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::genesis_amount - 150, node.ledger.account_balance (transaction, chratos::test_genesis_key.pub));
+	ASSERT_TRUE (node.store.pending_exists (transaction, chratos::pending_key (key1.pub, blocks[0]->hash ())));
+	ASSERT_TRUE (node.store.pending_exists (transaction, chratos::pending_key (key2.pub, blocks[1]->hash ())));
+}
+
+TEST (wallet, send_chain_insufficient_balance)
+{
+	chratos::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	system.wallet (0)->insert_adhoc (chratos::test_genesis_key.prv);
+	chratos::keypair key1;
+	auto head (node.latest (chratos::test_genesis_key.pub));
+	// The first send is covered on its own but not together with the second, so neither is made
+	std::vector<std::pair<chratos::account, chratos::uint128_t>> destinations{ { key1.pub, 100 }, { key1.pub, chratos::genesis_amount - 50 } };
+	auto blocks (system.wallet (0)->send_chain_action (chratos::test_genesis_key.pub, destinations));
+	ASSERT_TRUE (blocks.empty ());
+	ASSERT_EQ (head, node.latest (chratos::test_genesis_key.pub));
+	ASSERT_EQ (chratos::genesis_amount, node.balance (chratos::test_genesis_key.pub));
+}
+
+TEST (wallet, receive_chain)
+{
+	chratos::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	chratos::keypair key1;
+	chratos::genesis genesis;
+	// Below receive_minimum, so the node leaves the pending entries for the test to receive
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (send1).code);
+	chratos::state_block send2 (chratos::test_genesis_key.pub, send1.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 150, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (send2).code);
+	system.wallet (0)->insert_adhoc (key1.prv);
+	chratos::block_hash missing (1);
+	auto blocks (system.wallet (0)->receive_chain_action (key1.pub, { send1.hash (), missing, send2.hash () }, key1.pub));
+	// The send that isn't pending is skipped, the others are chained from the open block
+	ASSERT_EQ (2u, blocks.size ());
+	ASSERT_TRUE (blocks[0]->previous ().is_zero ());
+	ASSERT_EQ (blocks[0]->hash (), blocks[1]->previous ());
+	chratos::transaction transaction (node.store.environment, nullptr, false);
+	ASSERT_EQ (blocks[1]->hash (), node.ledger.latest (transaction, key1.pub));
+	ASSERT_EQ (150, node.ledger.account_balance (transaction, key1.pub));
+	ASSERT_EQ (key1.pub, blocks[1]->representative ());
+	ASSERT_FALSE (node.store.pending_exists (transaction, chratos::pending_key (key1.pub, send1.hash ())));
+	ASSERT_FALSE (node.store.pending_exists (transaction, chratos::pending_key (key1.pub, send2.hash ())));
+}
+
+TEST (wallet, claim_chain)
+{
+	chratos::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	chratos::keypair key1;
+	chratos::genesis genesis;
+	// Below receive_minimum, so the node leaves the pending entries for the test to receive
+	chratos::state_block send1 (chratos::test_genesis_key.pub, genesis.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (send1).code);
+	chratos::state_block open1 (key1.pub, 0, key1.pub, 100, send1.hash (), chratos::dividend_base, key1.prv, key1.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (open1).code);
+	// Fund the dividend account and pay out a dividend
+	auto dividend_amount (chratos::minimum_dividend_amount * 2);
+	chratos::state_block send2 (chratos::test_genesis_key.pub, send1.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 100 - dividend_amount, chratos::dividend_account, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (send2).code);
+	chratos::state_block open2 (chratos::dividend_account, 0, chratos::dividend_account, dividend_amount, send2.hash (), chratos::dividend_base, chratos::test_dividend_key.prv, chratos::test_dividend_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (open2).code);
+	chratos::dividend_block dividend1 (chratos::dividend_account, open2.hash (), chratos::dividend_account, 0, chratos::dividend_base, chratos::test_dividend_key.prv, chratos::test_dividend_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (dividend1).code);
+	// Sent under the base dividend after dividend1, it has to be received before dividend1 can be claimed
+	chratos::state_block send3 (chratos::test_genesis_key.pub, send2.hash (), chratos::test_genesis_key.pub, chratos::genesis_amount - 150 - dividend_amount, key1.pub, chratos::dividend_base, chratos::test_genesis_key.prv, chratos::test_genesis_key.pub, 0);
+	ASSERT_EQ (chratos::process_result::progress, node.process (send3).code);
+	system.wallet (0)->insert_adhoc (key1.prv);
+	auto blocks (system.wallet (0)->claim_chain_action (key1.pub, key1.pub, 0));
+	ASSERT_EQ (2u, blocks.size ());
+	ASSERT_EQ (chratos::block_type::state, blocks[0]->type ());
+	ASSERT_EQ (chratos::block_type::claim, blocks[1]->type ());
+	ASSERT_EQ (dividend1.hash (), blocks[1]->dividend ());
+	chratos::transaction transaction (node.store.environment, nullptr, false);
+	ASSERT_FALSE (node.store.pending_exists (transaction, chratos::pending_key (key1.pub, send3.hash ())));
+	chratos::account_info info;
+	ASSERT_FALSE (node.store.account_get (transaction, key1.pub, info));
+	ASSERT_EQ (blocks[1]->hash (), info.head);
+	ASSERT_EQ (dividend1.hash (), info.dividend_block);
+	ASSERT_EQ (150 + node.ledger.dividend_reward (transaction, dividend1.hash (), 150).number (), info.balance.number ());
+	ASSERT_TRUE (node.ledger.unclaimed_for_account (transaction, key1.pub).empty ());
+}
+
+TEST (wallet, expanded_key_signing)
+{
+	chratos::keypair key1;
+	chratos::expanded_key expanded (key1.prv);
+	chratos::block_hash hash (42);
+	auto signature (chratos::sign_message (expanded, key1.pub, hash));
+	ASSERT_EQ (chratos::sign_message (key1.prv, key1.pub, hash), signature);
+	ASSERT_FALSE (chratos::validate_message (key1.pub, hash, signature));
+	std::vector<chratos::block_hash> hashes{ chratos::block_hash (1), chratos::block_hash (2), chratos::block_hash (3) };
+	std::vector<chratos::signature> signatures (hashes.size ());
+	chratos::sign_message_batch (expanded, key1.pub, hashes.data (), hashes.size (), signatures.data ());
+	for (size_t i (0); i < hashes.size (); ++i)
+	{
+		ASSERT_EQ (chratos::sign_message (key1.prv, key1.pub, hashes[i]), signatures[i]);
+	}
+}
+
+TEST (wallet, expanded_key_cache_lock)
+{
+	chratos::system system (24000, 1);
+	auto wallet (system.wallet (0));
+	chratos::keypair key1;
+	wallet->insert_adhoc (key1.prv);
+	chratos::block_hash hash (42);
+	{
+		chratos::transaction transaction (wallet->store.environment, nullptr, false);
+		chratos::expanded_key expanded;
+		ASSERT_FALSE (wallet->store.fetch (transaction, key1.pub, expanded));
+		ASSERT_EQ (chratos::sign_message (key1.prv, key1.pub, hash), chratos::sign_message (expanded, key1.pub, hash));
+		// Served from the cache the second time
+		chratos::expanded_key expanded2;
+		ASSERT_FALSE (wallet->store.fetch (transaction, key1.pub, expanded2));
+		ASSERT_EQ (expanded.bytes, expanded2.bytes);
+	}
+	wallet->store.lock ();
+	{
+		chratos::transaction transaction (wallet->store.environment, nullptr, false);
+		chratos::expanded_key expanded;
+		ASSERT_TRUE (wallet->store.fetch (transaction, key1.pub, expanded));
+	}
+	ASSERT_FALSE (wallet->enter_password (""));
+	{
+		chratos::transaction transaction (wallet->store.environment, nullptr, true);
+		chratos::expanded_key expanded;
+		ASSERT_FALSE (wallet->store.fetch (transaction, key1.pub, expanded));
+		ASSERT_EQ (chratos::sign_message (key1.prv, key1.pub, hash), chratos::sign_message (expanded, key1.pub, hash));
+		wallet->store.erase (transaction, key1.pub);
+		ASSERT_TRUE (wallet->store.fetch (transaction, key1.pub, expanded));
+	}
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include <chratos/core_test/testutil.hpp>
+#include <chratos/node/testing.hpp>
+
+TEST (wallets, open_existing_before_start)
+{
+	boost::asio::io_service service;
+	chratos::alarm alarm (service);
+	chratos::logging logging;
+	logging.init (chratos::unique_path ());
+	chratos::work_pool work (1, nullptr);
+	auto path (chratos::unique_path ());
+	chratos::uint256_union id (1);
+	{
+		chratos::node_init init;
+		auto node (std::make_shared<chratos::node> (init, service, 24000, path, alarm, logging, work));
+		ASSERT_FALSE (init.error ());
+		ASSERT_NE (nullptr, node->wallets.create (id));
+		node->stop ();
+	}
+	chratos::node_init init;
+	auto node (std::make_shared<chratos::node> (init, service, 24000, path, alarm, logging, work));
+	ASSERT_FALSE (init.error ());
+	auto wallet (node->wallets.open (id));
+	ASSERT_NE (nullptr, wallet);
+	// The empty password is only entered for loaded wallets once node::start runs
+	ASSERT_TRUE (wallet->deterministic_insert ().is_zero ());
+	wallet->enter_initial_password ();
+	auto account (wallet->deterministic_insert ());
+	ASSERT_FALSE (account.is_zero ());
+	ASSERT_TRUE (wallet->exists (account));
+	node->stop ();
+}
+
+TEST (wallets, send_ids_persist)
+{
+	chratos::system system (24000, 1);
+	auto & wallets (system.nodes[0]->wallets);
+	chratos::block_hash hash (42);
+	{
+		chratos::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		ASSERT_FALSE (wallets.send_ids.put (transaction, wallets.send_action_ids, "id1", hash));
+	}
+	ASSERT_EQ (hash, *wallets.send_ids.find ("id1"));
+	ASSERT_FALSE (wallets.send_ids.find ("id2"));
+	chratos::send_id_index index;
+	{
+		chratos::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		index.load (transaction, wallets.send_action_ids);
+	}
+	ASSERT_EQ (1u, index.size ());
+	ASSERT_EQ (hash, *index.find ("id1"));
+	ASSERT_TRUE (index.expired (0, 16).empty ());
+	auto expired (index.expired (chratos::seconds_since_epoch () + 1, 16));
+	ASSERT_EQ (1u, expired.size ());
+	ASSERT_EQ ("id1", expired[0]);
+	{
+		chratos::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+		index.erase (transaction, wallets.send_action_ids, expired);
+		ASSERT_FALSE (index.find ("id1"));
+		wallets.send_ids.load (transaction, wallets.send_action_ids);
+	}
+	ASSERT_EQ (0u, wallets.send_ids.size ());
+}
+
+TEST (wallets, send_ids_legacy_upgrade)
+{
+	chratos::system system (24000, 1);
+	auto & wallets (system.nodes[0]->wallets);
+	chratos::block_hash hash (42);
+	std::string id ("legacy");
+	chratos::transaction transaction (system.nodes[0]->store.environment, nullptr, true);
+	// Rows used to hold only the block hash
+	ASSERT_EQ (0, mdb_put (transaction, wallets.send_action_ids, chratos::mdb_val (id.size (), const_cast<char *> (id.data ())), chratos::mdb_val (hash), 0));
+	auto now (chratos::seconds_since_epoch ());
+	wallets.send_ids.load (transaction, wallets.send_action_ids);
+	ASSERT_EQ (hash, *wallets.send_ids.find (id));
+	chratos::mdb_val value;
+	ASSERT_EQ (0, mdb_get (transaction, wallets.send_action_ids, chratos::mdb_val (id.size (), const_cast<char *> (id.data ())), value));
+	ASSERT_EQ (sizeof (chratos::block_hash) + sizeof (uint64_t), value.size ());
+	// The load time is kept as the time the ID was first seen
+	ASSERT_TRUE (wallets.send_ids.expired (now, 16).empty ());
+	chratos::send_id_index index;
+	index.load (transaction, wallets.send_action_ids);
+	ASSERT_EQ (1u, index.expired (chratos::seconds_since_epoch () + 1, 16).size ());
+}
+
+TEST (wallets, expire_send_ids)
+{
+	chratos::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto & wallets (node.wallets);
+	node.config.send_id_retention = 1;
+	{
+		chratos::transaction transaction (node.store.environment, nullptr, true);
+		// Written two hours ago
+		std::vector<uint8_t> value;
+		{
+			chratos::vectorstream stream (value);
+			chratos::write (stream, chratos::block_hash (1));
+			chratos::write (stream, boost::endian::native_to_big (chratos::seconds_since_epoch () - 7200));
+		}
+		std::string old_id ("old");
+		ASSERT_EQ (0, mdb_put (transaction, wallets.send_action_ids, chratos::mdb_val (old_id.size (), const_cast<char *> (old_id.data ())), chratos::mdb_val (value.size (), value.data ()), 0));
+		wallets.send_ids.load (transaction, wallets.send_action_ids);
+		ASSERT_FALSE (wallets.send_ids.put (transaction, wallets.send_action_ids, "new", chratos::block_hash (2)));
+	}
+	ASSERT_EQ (2u, wallets.send_ids.size ());
+	ASSERT_EQ (1u, wallets.expire_send_ids ());
+	ASSERT_FALSE (wallets.send_ids.find ("old"));
+	ASSERT_EQ (chratos::block_hash (2), *wallets.send_ids.find ("new"));
+	chratos::send_id_index index;
+	{
+		chratos::transaction transaction (node.store.environment, nullptr, true);
+		index.load (transaction, wallets.send_action_ids);
+	}
+	ASSERT_EQ (1u, index.size ());
+	// Retention of zero keeps IDs forever
+	node.config.send_id_retention = 0;
+	ASSERT_EQ (0u, wallets.expire_send_ids ());
+}
@@ -158,6 +158,13 @@ work (work_a)
 {
 }
 
+chratos::state_block::state_block (chratos::account const & account_a, chratos::block_hash const & previous_a, chratos::account const & representative_a, chratos::amount const & balance_a, chratos::uint256_union const & link_a, chratos::block_hash const & dividend_a, uint64_t work_a) :
+hashables (account_a, previous_a, representative_a, balance_a, link_a, dividend_a),
+signature (0),
+work (work_a)
+{
+}
+
 chratos::state_block::state_block (bool & error_a, chratos::stream & stream_a) :
 hashables (error_a, stream_a)
 {
@@ -1008,6 +1015,13 @@ work (work_a)
 {
 }
 
+chratos::claim_block::claim_block (chratos::account const & account_a, chratos::block_hash const & previous_a, chratos::account const & representative_a, chratos::amount const & balance_a, chratos::block_hash const & dividend_a, uint64_t work_a) :
+hashables (account_a, previous_a, representative_a, balance_a, dividend_a),
+signature (0),
+work (work_a)
+{
+}
+
 chratos::claim_block::claim_block (bool & error_a, chratos::stream & stream_a) :
 hashables (error_a, stream_a)
 {
@@ -93,6 +93,8 @@ class state_block : public chratos::block
 {
 public:
 	state_block (chratos::account const &, chratos::block_hash const &, chratos::account const &, chratos::amount const &, chratos::uint256_union const &, chratos::block_hash const &, chratos::raw_key const &, chratos::public_key const &, uint64_t);
+	// Unsigned, for callers that sign many blocks at once through signature_set
+	state_block (chratos::account const &, chratos::block_hash const &, chratos::account const &, chratos::amount const &, chratos::uint256_union const &, chratos::block_hash const &, uint64_t);
 	state_block (bool &, chratos::stream &);
 	state_block (bool &, boost::property_tree::ptree const &);
 	virtual ~state_block () = default;
@@ -185,6 +187,8 @@ class claim_block : public chratos::block
 {
 public:
 	claim_block (chratos::account const &, chratos::block_hash const &, chratos::account const &, chratos::amount const &, chratos::block_hash const &, chratos::raw_key const &, chratos::public_key const &, uint64_t);
+	// Unsigned, for callers that sign many blocks at once through signature_set
+	claim_block (chratos::account const &, chratos::block_hash const &, chratos::account const &, chratos::amount const &, chratos::block_hash const &, uint64_t);
 	claim_block (bool &, chratos::stream &);
 	claim_block (bool &, boost::property_tree::ptree const &);
 	virtual ~claim_block () = default;
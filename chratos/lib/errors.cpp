@@ -122,16 +122,24 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Invalid balance number";
 		case nano::error_rpc::invalid_destinations:
 			return "Invalid destinations number";
+		case nano::error_rpc::invalid_key_and_hash:
+			return "Only one of key and hash can be given";
 		case nano::error_rpc::invalid_offset:
 			return "Invalid offset";
 		case nano::error_rpc::invalid_missing_type:
 			return "Invalid or missing type argument";
 		case nano::error_rpc::invalid_sources:
 			return "Invalid sources number";
+		case nano::error_rpc::node_starting:
+			return "Node is starting, retry later";
 		case nano::error_rpc::payment_account_balance:
 			return "Account has non-zero balance";
 		case nano::error_rpc::payment_unable_create_account:
 			return "Unable to create transaction account";
+		case nano::error_rpc::queue_full:
+			return "Too many pending requests, retry later";
+		case nano::error_rpc::request_not_found:
+			return "Request not found";
 		case nano::error_rpc::rpc_control_disabled:
 			return "RPC control is disabled";
 		case nano::error_rpc::source_not_found:
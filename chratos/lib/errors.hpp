@@ -87,11 +87,15 @@ enum class error_rpc
 	block_create_requirements_send,
 	invalid_balance,
 	invalid_destinations,
+	invalid_key_and_hash,
 	invalid_offset,
 	invalid_missing_type,
 	invalid_sources,
+	node_starting,
 	payment_account_balance,
 	payment_unable_create_account,
+	queue_full,
+	request_not_found,
 	rpc_control_disabled,
 	source_not_found
 };
@@ -379,6 +379,21 @@ chratos::raw_key::~raw_key ()
 	data.clear ();
 }
 
+chratos::expanded_key::expanded_key (chratos::raw_key const & prv_a)
+{
+	ed25519_secret_expand (prv_a.data.bytes.data (), bytes.data ());
+}
+
+chratos::expanded_key::~expanded_key ()
+{
+	clear ();
+}
+
+void chratos::expanded_key::clear ()
+{
+	bytes.fill (0);
+}
+
 bool chratos::raw_key::operator== (chratos::raw_key const & other_a) const
 {
 	return data == other_a.data;
@@ -404,6 +419,34 @@ chratos::uint512_union chratos::sign_message (chratos::raw_key const & private_k
 	return result;
 }
 
+chratos::uint512_union chratos::sign_message (chratos::expanded_key const & private_key, chratos::public_key const & public_key, chratos::uint256_union const & message)
+{
+	chratos::uint512_union result;
+	ed25519_sign_expanded (message.bytes.data (), sizeof (message.bytes), private_key.bytes.data (), public_key.bytes.data (), result.bytes.data ());
+	return result;
+}
+
+void chratos::sign_message_batch (chratos::expanded_key const & private_key, chratos::public_key const & public_key, chratos::uint256_union const * messages, size_t size, chratos::uint512_union * signatures)
+{
+	for (size_t i (0); i < size; ++i)
+	{
+		ed25519_sign_expanded (messages[i].bytes.data (), sizeof (messages[i].bytes), private_key.bytes.data (), public_key.bytes.data (), signatures[i].bytes.data ());
+	}
+}
+
+void chratos::sign_message_batch (chratos::raw_key const & private_key, chratos::public_key const & public_key, chratos::uint256_union const * messages, size_t size, chratos::uint512_union * signatures)
+{
+	std::vector<unsigned char const *> messages_l (size);
+	std::vector<size_t> lengths (size, sizeof (chratos::uint256_union));
+	std::vector<unsigned char *> signatures_l (size);
+	for (size_t i (0); i < size; ++i)
+	{
+		messages_l[i] = messages[i].bytes.data ();
+		signatures_l[i] = signatures[i].bytes.data ();
+	}
+	ed25519_sign_batch (messages_l.data (), lengths.data (), private_key.data.bytes.data (), public_key.bytes.data (), signatures_l.data (), size);
+}
+
 void chratos::deterministic_key (chratos::uint256_union const & seed_a, uint32_t index_a, chratos::uint256_union & prv_a)
 {
 	blake2b_state hash;
@@ -427,6 +470,11 @@ bool chratos::validate_message (chratos::public_key const & public_key, chratos:
 	return result;
 }
 
+void chratos::validate_message_batch (unsigned char const ** messages, size_t * message_lengths, unsigned char const ** public_keys, unsigned char const ** signatures, size_t size, int * valid)
+{
+	ed25519_sign_open_batch (messages, message_lengths, public_keys, signatures, size, valid);
+}
+
 chratos::uint128_union::uint128_union (std::string const & string_a)
 {
 	decode_hex (string_a);
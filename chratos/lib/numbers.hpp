@@ -98,6 +98,16 @@ public:
 	bool operator!= (chratos::raw_key const &) const;
 	chratos::uint256_union data;
 };
+// Private key with the hash and clamp ed25519 applies before every signature already done, cleared on destruction
+class expanded_key
+{
+public:
+	expanded_key () = default;
+	expanded_key (chratos::raw_key const &);
+	~expanded_key ();
+	void clear ();
+	std::array<uint8_t, 64> bytes;
+};
 union uint512_union
 {
 	uint512_union () = default;
@@ -119,7 +129,13 @@ union uint512_union
 using signature = uint512_union;
 
 chratos::uint512_union sign_message (chratos::raw_key const &, chratos::public_key const &, chratos::uint256_union const &);
+chratos::uint512_union sign_message (chratos::expanded_key const &, chratos::public_key const &, chratos::uint256_union const &);
+// Sign size messages with one key, expanding the secret once for the whole batch
+void sign_message_batch (chratos::raw_key const &, chratos::public_key const &, chratos::uint256_union const *, size_t, chratos::uint512_union *);
+void sign_message_batch (chratos::expanded_key const &, chratos::public_key const &, chratos::uint256_union const *, size_t, chratos::uint512_union *);
 bool validate_message (chratos::public_key const &, chratos::uint256_union const &, chratos::uint512_union const &);
+// Verify several signatures at once, valid[i] is set to 1 for each signature which verifies and 0 otherwise
+void validate_message_batch (unsigned char const **, size_t *, unsigned char const **, unsigned char const **, size_t, int *);
 void deterministic_key (chratos::uint256_union const &, uint32_t, chratos::uint256_union &);
 chratos::public_key pub_key (chratos::private_key const &);
 }
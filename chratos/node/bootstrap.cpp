@@ -13,6 +13,10 @@ constexpr unsigned bootstrap_frontier_retry_limit = 16;
 constexpr double bootstrap_minimum_termination_time_sec = 30.0;
 constexpr unsigned bootstrap_max_new_connections = 10;
 constexpr unsigned bulk_push_cost_limit = 200;
+constexpr size_t bulk_pull_account_entries_per_write = 1024;
+constexpr size_t bulk_pull_delta_blocks_per_write = 32;
+constexpr std::chrono::milliseconds bulk_pull_account_transaction_max = std::chrono::milliseconds (50);
+constexpr size_t bulk_pull_account_deduplication_max = 64 * 1024;
 
 chratos::socket::socket (std::shared_ptr<chratos::node> node_a) :
 socket_m (node_a->service),
@@ -411,6 +415,8 @@ void chratos::bulk_pull_client::request ()
 	chratos::bulk_pull req;
 	req.start = pull.account;
 	req.end = pull.end;
+	// Servers that don't know the flag ignore it and send full blocks, which are still accepted
+	req.delta_set (true);
 	auto buffer (std::make_shared<std::vector<uint8_t>> ());
 	{
 		chratos::vectorstream stream (*buffer);
@@ -463,7 +469,23 @@ void chratos::bulk_pull_client::receive_block ()
 void chratos::bulk_pull_client::received_type ()
 {
 	auto this_l (shared_from_this ());
-	chratos::block_type type (static_cast<chratos::block_type> (connection->receive_buffer->data ()[0]));
+	auto header (connection->receive_buffer->data ()[0]);
+	if (header & chratos::bulk_pull::delta_marker)
+	{
+		auto size (chratos::block_delta_size (header));
+		if (size != 0)
+		{
+			connection->socket->async_read (connection->receive_buffer, size, [this_l, header](boost::system::error_code const & ec, size_t size_a) {
+				this_l->received_delta_block (ec, size_a, header);
+			});
+		}
+		else if (connection->node->config.logging.network_packet_logging ())
+		{
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unknown delta block header received: %1%") % static_cast<int> (header));
+		}
+		return;
+	}
+	chratos::block_type type (static_cast<chratos::block_type> (header));
 	switch (type)
 	{
 		case chratos::block_type::state:
@@ -513,43 +535,68 @@ void chratos::bulk_pull_client::received_block (boost::system::error_code const
 	{
 		chratos::bufferstream stream (connection->receive_buffer->data (), size_a);
 		std::shared_ptr<chratos::block> block (chratos::deserialize_block (stream, type_a));
-		if (block != nullptr && !chratos::work_validate (*block))
+		connection->node->stats.add (chratos::stat::type::traffic, chratos::stat::detail::bulk_pull, chratos::stat::dir::in, 1 + size_a);
+		received (block);
+	}
+	else
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			auto hash (block->hash ());
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				std::string block_l;
-				block->serialize_json (block_l);
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
-			}
-			if (hash == expected)
-			{
-				expected = block->previous ();
-			}
-			if (connection->block_count++ == 0)
-			{
-				connection->start_time = std::chrono::steady_clock::now ();
-			}
-			connection->attempt->total_blocks++;
-			connection->attempt->node->block_processor.add (block, std::chrono::steady_clock::time_point ());
-			if (!connection->hard_stop.load ())
-			{
-				receive_block ();
-			}
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ());
 		}
-		else
+	}
+}
+
+void chratos::bulk_pull_client::received_delta_block (boost::system::error_code const & ec, size_t size_a, uint8_t header_a)
+{
+	if (!ec)
+	{
+		chratos::bufferstream stream (connection->receive_buffer->data (), size_a);
+		std::shared_ptr<chratos::block> block (chratos::deserialize_block_delta (stream, header_a, last.get ()));
+		connection->node->stats.add (chratos::stat::type::traffic, chratos::stat::detail::bulk_pull, chratos::stat::dir::in, 1 + size_a);
+		received (block);
+	}
+	else
+	{
+		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
-			}
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error bulk receiving delta block: %1%") % ec.message ());
+		}
+	}
+}
+
+void chratos::bulk_pull_client::received (std::shared_ptr<chratos::block> block_a)
+{
+	if (block_a != nullptr && !chratos::work_validate (*block_a))
+	{
+		last = block_a;
+		auto hash (block_a->hash ());
+		if (connection->node->config.logging.bulk_pull_logging ())
+		{
+			std::string block_l;
+			block_a->serialize_json (block_l);
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
+		}
+		if (hash == expected)
+		{
+			expected = block_a->previous ();
+		}
+		if (connection->block_count++ == 0)
+		{
+			connection->start_time = std::chrono::steady_clock::now ();
+		}
+		connection->attempt->total_blocks++;
+		connection->attempt->node->block_processor.add (block_a, std::chrono::steady_clock::time_point ());
+		if (!connection->hard_stop.load ())
+		{
+			receive_block ();
 		}
 	}
 	else
 	{
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ());
+			BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
 		}
 	}
 }
@@ -1637,13 +1684,34 @@ void chratos::bulk_pull_server::send_next ()
 		{
 			send_buffer->clear ();
 			chratos::vectorstream stream (*send_buffer);
-			chratos::serialize_block (stream, *block);
+			if (request->delta ())
+			{
+				// Delta encoded blocks are small, so several go out in each write
+				for (size_t count (0); block != nullptr;)
+				{
+					if (connection->node->config.logging.bulk_pull_logging ())
+					{
+						BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending delta block: %1%") % block->hash ().to_string ());
+					}
+					chratos::serialize_block_delta (stream, *block, last.get ());
+					last = std::move (block);
+					if (++count < bulk_pull_delta_blocks_per_write)
+					{
+						block = get_next ();
+					}
+				}
+			}
+			else
+			{
+				chratos::serialize_block (stream, *block);
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
+				}
+			}
 		}
+		connection->node->stats.add (chratos::stat::type::traffic, chratos::stat::detail::bulk_pull, chratos::stat::dir::out, send_buffer->size ());
 		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
-		}
 		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
 			this_l->sent_action (ec, size_a);
 		});
@@ -1857,44 +1925,22 @@ void chratos::bulk_pull_account_server::send_frontier ()
 void chratos::bulk_pull_account_server::send_next_block ()
 {
 	/*
-	 * Get the next item from the queue, it is a tuple with the key (which
-	 * contains the account and hash) and data (which contains the amount)
+	 * Fill the send buffer with as many pending entries as fit in
+	 * one write.  A fill can come back empty without the account
+	 * being exhausted if every entry it visited was filtered out, so
+	 * keep going until we either have something to send or run out.
 	 */
-	auto block_data (get_next ());
-	auto block_info_key (block_data.first.get ());
-	auto block_info (block_data.second.get ());
+	size_t entries (0);
+	while (entries == 0 && !pending_exhausted)
+	{
+		entries = fill_buffer ();
+	}
 
-	if (block_info_key != nullptr)
+	if (entries != 0)
 	{
 		/*
-		 * If we have a new item, emit it to the socket
+		 * If we have new items, emit them to the socket
 		 */
-		send_buffer->clear ();
-
-		if (pending_address_only)
-		{
-			chratos::vectorstream output_stream (*send_buffer);
-
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending address: %1%") % block_info->source.to_string ());
-			}
-
-			write (output_stream, block_info->source.bytes);
-		}
-		else
-		{
-			chratos::vectorstream output_stream (*send_buffer);
-
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block_info_key->hash.to_string ());
-			}
-
-			write (output_stream, block_info_key->hash.bytes);
-			write (output_stream, block_info->amount.bytes);
-		}
-
 		auto this_l (shared_from_this ());
 		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
 			this_l->sent_action (ec, size_a);
@@ -1914,73 +1960,141 @@ void chratos::bulk_pull_account_server::send_next_block ()
 	}
 }
 
-std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> chratos::bulk_pull_account_server::get_next ()
+size_t chratos::bulk_pull_account_server::fill_buffer ()
 {
-	std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> result;
+	size_t result (0);
+	send_buffer->clear ();
+
+	/*
+	 * Establish a read transaction and a single cursor positioned at
+	 * the current key, then stream entries from it until the buffer
+	 * holds a full write or the transaction has been held for long
+	 * enough.  The transaction is dropped before writing so the
+	 * database is never locked across socket operations.
+	 */
+	chratos::transaction stream_transaction (connection->node->store.environment, nullptr, false);
+	auto stream (connection->node->store.pending_begin (stream_transaction, current_key));
+	auto cutoff (std::chrono::steady_clock::now () + bulk_pull_account_transaction_max);
 
-	while (true)
 	{
-		/*
-		 * For each iteration of this loop, establish and then
-		 * destroy a database transaction, to avoid locking the
-		 * database for a prolonged period.
-		 */
-		chratos::transaction stream_transaction (connection->node->store.environment, nullptr, false);
-		auto stream (connection->node->store.pending_begin (stream_transaction, current_key));
+		chratos::vectorstream output_stream (*send_buffer);
 
-		if (stream == chratos::store_iterator<chratos::pending_key, chratos::pending_info> (nullptr))
+		while (result < bulk_pull_account_entries_per_write && !pending_exhausted && std::chrono::steady_clock::now () < cutoff)
 		{
-			break;
-		}
+			/*
+			 * Get the next item from the stream, it is a tuple with the key (which
+			 * contains the account and hash) and data (which contains the amount)
+			 */
+			auto block_data (get_next (stream));
+			auto block_info_key (block_data.first.get ());
+			auto block_info (block_data.second.get ());
 
-		chratos::pending_key key (stream->first);
-		chratos::pending_info info (stream->second);
+			if (block_info_key == nullptr)
+			{
+				continue;
+			}
 
-		/*
-		 * Get the key for the next value, to use in the next call or iteration
-		 */
-		current_key.account = key.account;
-		current_key.hash = key.hash.number () + 1;
+			if (pending_address_only)
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending address: %1%") % block_info->source.to_string ());
+				}
 
-		/*
-		 * Finish up if the response is for a different account
-		 */
-		if (key.account != request->account)
-		{
-			break;
+				write (output_stream, block_info->source.bytes);
+			}
+			else
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block_info_key->hash.to_string ());
+				}
+
+				write (output_stream, block_info_key->hash.bytes);
+				write (output_stream, block_info->amount.bytes);
+			}
+
+			++result;
 		}
+	}
 
-		/*
-		 * Skip entries where the amount is less than the requested
-		 * minimum
-		 */
-		if (info.amount < request->minimum_amount)
+	return result;
+}
+
+std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> chratos::bulk_pull_account_server::get_next (chratos::store_iterator<chratos::pending_key, chratos::pending_info> & stream_a)
+{
+	std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> result;
+
+	/*
+	 * The stream merges both the pending_v0 and pending_v1 tables
+	 * so entries of either epoch are returned in key order
+	 */
+	if (stream_a == connection->node->store.pending_end ())
+	{
+		pending_exhausted = true;
+
+		return result;
+	}
+
+	chratos::pending_key key (stream_a->first);
+	chratos::pending_info info (stream_a->second);
+
+	/*
+	 * Finish up if the response is for a different account
+	 */
+	if (key.account != request->account)
+	{
+		pending_exhausted = true;
+
+		return result;
+	}
+
+	/*
+	 * Get the key for the next value, to resume from when the
+	 * transaction is refreshed
+	 */
+	current_key.account = key.account;
+	current_key.hash = key.hash.number () + 1;
+	++stream_a;
+
+	/*
+	 * Skip entries where the amount is less than the requested
+	 * minimum
+	 */
+	if (info.amount < request->minimum_amount)
+	{
+		return result;
+	}
+
+	/*
+	 * If the pending_address_only flag is set, de-duplicate the
+	 * responses.  The responses are the address of the sender,
+	 * so they are are part of the pending table's information
+	 * and not key, so we have to de-duplicate them manually.
+	 *
+	 * The set is bounded so an account with a huge number of
+	 * distinct senders cannot grow it without limit, once it is
+	 * full it starts over and an address may be repeated, which
+	 * the requestor has to tolerate anyway.
+	 */
+	if (pending_address_only)
+	{
+		if (deduplication.count (info.source) != 0)
 		{
-			continue;
+			return result;
 		}
 
-		/*
-		 * If the pending_address_only flag is set, de-duplicate the
-		 * responses.  The responses are the address of the sender,
-		 * so they are are part of the pending table's information
-		 * and not key, so we have to de-duplicate them manually.
-		 */
-		if (pending_address_only)
+		if (deduplication.size () >= bulk_pull_account_deduplication_max)
 		{
-			if (deduplication.count (info.source) != 0)
-			{
-				continue;
-			}
-
-			deduplication.insert ({ info.source, true });
+			deduplication.clear ();
 		}
 
-		result.first = std::unique_ptr<chratos::pending_key> (new chratos::pending_key (key));
-		result.second = std::unique_ptr<chratos::pending_info> (new chratos::pending_info (info));
-
-		break;
+		deduplication.insert (info.source);
 	}
 
+	result.first = std::unique_ptr<chratos::pending_key> (new chratos::pending_key (key));
+	result.second = std::unique_ptr<chratos::pending_info> (new chratos::pending_info (info));
+
 	return result;
 }
 
@@ -2062,7 +2176,8 @@ chratos::bulk_pull_account_server::bulk_pull_account_server (std::shared_ptr<chr
 connection (connection_a),
 request (std::move (request_a)),
 send_buffer (std::make_shared<std::vector<uint8_t>> ()),
-current_key (0, 0)
+current_key (0, 0),
+pending_exhausted (false)
 {
 	/*
 	 * Setup the streaming response for the first call to "send_frontier" and  "send_next_block"
@@ -130,10 +130,14 @@ public:
 	void receive_block ();
 	void received_type ();
 	void received_block (boost::system::error_code const &, size_t, chratos::block_type);
+	void received_delta_block (boost::system::error_code const &, size_t, uint8_t);
+	void received (std::shared_ptr<chratos::block>);
 	chratos::block_hash first ();
 	std::shared_ptr<chratos::bootstrap_client> connection;
 	chratos::block_hash expected;
 	chratos::pull_info pull;
+	// Previous block in the stream, delta encoded blocks are relative to it
+	std::shared_ptr<chratos::block> last;
 };
 class bootstrap_client : public std::enable_shared_from_this<bootstrap_client>
 {
@@ -247,6 +251,7 @@ public:
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
 	chratos::block_hash current;
 	bool include_start;
+	std::unique_ptr<chratos::block> last;
 };
 class bulk_pull_account;
 class bulk_pull_account_server : public std::enable_shared_from_this<chratos::bulk_pull_account_server>
@@ -254,7 +259,8 @@ class bulk_pull_account_server : public std::enable_shared_from_this<chratos::bu
 public:
 	bulk_pull_account_server (std::shared_ptr<chratos::bootstrap_server> const &, std::unique_ptr<chratos::bulk_pull_account>);
 	void set_params ();
-	std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> get_next ();
+	std::pair<std::unique_ptr<chratos::pending_key>, std::unique_ptr<chratos::pending_info>> get_next (chratos::store_iterator<chratos::pending_key, chratos::pending_info> &);
+	size_t fill_buffer ();
 	void send_frontier ();
 	void send_next_block ();
 	void sent_action (boost::system::error_code const &, size_t);
@@ -263,9 +269,10 @@ public:
 	std::shared_ptr<chratos::bootstrap_server> connection;
 	std::unique_ptr<chratos::bulk_pull_account> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
-	std::unordered_map<chratos::uint256_union, bool> deduplication;
+	std::unordered_set<chratos::uint256_union> deduplication;
 	chratos::pending_key current_key;
 	bool pending_address_only;
+	bool pending_exhausted;
 	bool invalid_request;
 };
 class bulk_pull_blocks;
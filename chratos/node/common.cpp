@@ -8,6 +8,13 @@ std::array<uint8_t, 2> constexpr chratos::message_header::magic_number;
 size_t constexpr chratos::message_header::ipv4_only_position;
 size_t constexpr chratos::message_header::bootstrap_server_position;
 std::bitset<16> constexpr chratos::message_header::block_type_mask;
+size_t constexpr chratos::bulk_pull::delta_flag;
+uint8_t constexpr chratos::bulk_pull::delta_marker;
+uint8_t constexpr chratos::bulk_pull::delta_type_mask;
+uint8_t constexpr chratos::bulk_pull::delta_same_account;
+uint8_t constexpr chratos::bulk_pull::delta_same_representative;
+uint8_t constexpr chratos::bulk_pull::delta_same_dividend;
+uint8_t constexpr chratos::bulk_pull::delta_zero_previous;
 
 chratos::message_header::message_header (chratos::message_type type_a) :
 version_max (chratos::protocol_version),
@@ -532,6 +539,160 @@ void chratos::bulk_pull::serialize (chratos::stream & stream_a)
 	write (stream_a, end);
 }
 
+bool chratos::bulk_pull::delta () const
+{
+	return header.extensions.test (delta_flag);
+}
+
+void chratos::bulk_pull::delta_set (bool value_a)
+{
+	header.extensions.set (delta_flag, value_a);
+}
+
+namespace
+{
+/*
+ * Every block type serializes account, previous and representative first, state blocks then balance and link before the dividend
+ */
+size_t const delta_account_offset (0);
+size_t const delta_previous_offset (sizeof (chratos::account));
+size_t const delta_representative_offset (delta_previous_offset + sizeof (chratos::block_hash));
+size_t delta_dividend_offset (chratos::block_type type_a)
+{
+	return delta_representative_offset + sizeof (chratos::account) + sizeof (chratos::amount) + (type_a == chratos::block_type::state ? sizeof (chratos::uint256_union) : 0);
+}
+size_t delta_full_size (chratos::block_type type_a)
+{
+	size_t result (0);
+	switch (type_a)
+	{
+		case chratos::block_type::state:
+			result = chratos::state_block::size;
+			break;
+		case chratos::block_type::dividend:
+			result = chratos::dividend_block::size;
+			break;
+		case chratos::block_type::claim:
+			result = chratos::claim_block::size;
+			break;
+		default:
+			break;
+	}
+	return result;
+}
+// Omitted fields as (offset, size) in serialized order
+std::vector<std::pair<size_t, size_t>> delta_omitted (uint8_t header_a)
+{
+	std::vector<std::pair<size_t, size_t>> result;
+	auto type (static_cast<chratos::block_type> (header_a & chratos::bulk_pull::delta_type_mask));
+	if (header_a & chratos::bulk_pull::delta_same_account)
+	{
+		result.push_back (std::make_pair (delta_account_offset, sizeof (chratos::account)));
+	}
+	if (header_a & chratos::bulk_pull::delta_zero_previous)
+	{
+		result.push_back (std::make_pair (delta_previous_offset, sizeof (chratos::block_hash)));
+	}
+	if (header_a & chratos::bulk_pull::delta_same_representative)
+	{
+		result.push_back (std::make_pair (delta_representative_offset, sizeof (chratos::account)));
+	}
+	if (header_a & chratos::bulk_pull::delta_same_dividend)
+	{
+		result.push_back (std::make_pair (delta_dividend_offset (type), sizeof (chratos::block_hash)));
+	}
+	return result;
+}
+}
+
+void chratos::serialize_block_delta (chratos::stream & stream_a, chratos::block const & block_a, chratos::block const * reference_a)
+{
+	uint8_t header (chratos::bulk_pull::delta_marker | static_cast<uint8_t> (block_a.type ()));
+	if (reference_a != nullptr)
+	{
+		header |= block_a.account () == reference_a->account () ? chratos::bulk_pull::delta_same_account : 0;
+		header |= block_a.representative () == reference_a->representative () ? chratos::bulk_pull::delta_same_representative : 0;
+		header |= block_a.dividend () == reference_a->dividend () ? chratos::bulk_pull::delta_same_dividend : 0;
+	}
+	header |= block_a.previous ().is_zero () ? chratos::bulk_pull::delta_zero_previous : 0;
+	std::vector<uint8_t> full;
+	{
+		chratos::vectorstream stream (full);
+		block_a.serialize (stream);
+	}
+	write (stream_a, header);
+	size_t position (0);
+	for (auto & i : delta_omitted (header))
+	{
+		stream_a.sputn (full.data () + position, i.first - position);
+		position = i.first + i.second;
+	}
+	stream_a.sputn (full.data () + position, full.size () - position);
+}
+
+size_t chratos::block_delta_size (uint8_t header_a)
+{
+	size_t result (0);
+	if (header_a & chratos::bulk_pull::delta_marker)
+	{
+		result = delta_full_size (static_cast<chratos::block_type> (header_a & chratos::bulk_pull::delta_type_mask));
+		if (result != 0)
+		{
+			for (auto & i : delta_omitted (header_a))
+			{
+				result -= i.second;
+			}
+		}
+	}
+	return result;
+}
+
+std::unique_ptr<chratos::block> chratos::deserialize_block_delta (chratos::stream & stream_a, uint8_t header_a, chratos::block const * reference_a)
+{
+	std::unique_ptr<chratos::block> result;
+	auto type (static_cast<chratos::block_type> (header_a & chratos::bulk_pull::delta_type_mask));
+	auto size (block_delta_size (header_a));
+	auto needs_reference (header_a & (chratos::bulk_pull::delta_same_account | chratos::bulk_pull::delta_same_representative | chratos::bulk_pull::delta_same_dividend));
+	if (size != 0 && (reference_a != nullptr || !needs_reference))
+	{
+		// Rebuild the full serialization by filling the omitted fields back in
+		std::vector<uint8_t> full (delta_full_size (type));
+		auto error (false);
+		size_t position (0);
+		auto fill = [&full](size_t offset_a, chratos::uint256_union const & value_a) {
+			std::copy (value_a.bytes.begin (), value_a.bytes.end (), full.begin () + offset_a);
+		};
+		for (auto & i : delta_omitted (header_a))
+		{
+			error |= stream_a.sgetn (full.data () + position, i.first - position) != static_cast<std::streamsize> (i.first - position);
+			if (i.first == delta_account_offset)
+			{
+				fill (i.first, reference_a->account ());
+			}
+			else if (i.first == delta_previous_offset)
+			{
+				fill (i.first, chratos::block_hash (0));
+			}
+			else if (i.first == delta_representative_offset)
+			{
+				fill (i.first, reference_a->representative ());
+			}
+			else
+			{
+				fill (i.first, reference_a->dividend ());
+			}
+			position = i.first + i.second;
+		}
+		error |= stream_a.sgetn (full.data () + position, full.size () - position) != static_cast<std::streamsize> (full.size () - position);
+		if (!error)
+		{
+			chratos::bufferstream stream (full.data (), full.size ());
+			result = chratos::deserialize_block (stream, type);
+		}
+	}
+	return result;
+}
+
 chratos::bulk_pull_account::bulk_pull_account () :
 message (chratos::message_type::bulk_pull_account)
 {
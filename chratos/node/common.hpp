@@ -281,9 +281,25 @@ public:
 	bool deserialize (chratos::stream &) override;
 	void serialize (chratos::stream &) override;
 	void visit (chratos::message_visitor &) const override;
+	bool delta () const;
+	void delta_set (bool);
 	chratos::uint256_union start;
 	chratos::block_hash end;
+	// Requests a stream where each block is encoded relative to the block sent before it
+	static size_t constexpr delta_flag = 0;
+	// Leading byte of a delta encoded block, combined with the block type and the fields left out
+	static uint8_t constexpr delta_marker = 0x80;
+	static uint8_t constexpr delta_type_mask = 0x07;
+	static uint8_t constexpr delta_same_account = 0x08;
+	static uint8_t constexpr delta_same_representative = 0x10;
+	static uint8_t constexpr delta_same_dividend = 0x20;
+	static uint8_t constexpr delta_zero_previous = 0x40;
 };
+// Write block_a leaving out the account, representative and dividend where they match reference_a, and a zero previous
+void serialize_block_delta (chratos::stream &, chratos::block const &, chratos::block const *);
+// Size of a delta encoded block following its leading byte, zero if the leading byte isn't valid
+size_t block_delta_size (uint8_t);
+std::unique_ptr<chratos::block> deserialize_block_delta (chratos::stream &, uint8_t, chratos::block const *);
 class bulk_pull_account : public message
 {
 public:
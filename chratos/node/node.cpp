@@ -27,11 +27,26 @@ std::chrono::seconds constexpr chratos::node::period;
 std::chrono::seconds constexpr chratos::node::cutoff;
 std::chrono::seconds constexpr chratos::node::syn_cookie_cutoff;
 std::chrono::minutes constexpr chratos::node::backup_interval;
+std::chrono::minutes constexpr chratos::node::peer_snapshot_interval;
+std::chrono::hours constexpr chratos::node::peer_snapshot_cutoff;
+std::chrono::minutes constexpr chratos::node::send_id_expiry_interval;
+size_t constexpr chratos::node::unchecked_clear_batch;
+std::chrono::milliseconds constexpr chratos::node::unchecked_clear_interval;
 int constexpr chratos::port_mapping::mapping_timeout;
 int constexpr chratos::port_mapping::check_timeout;
 unsigned constexpr chratos::active_transactions::announce_interval_ms;
+unsigned constexpr chratos::network::merge_peers_interval_ms;
+size_t constexpr chratos::network::merge_peers_max;
 size_t constexpr chratos::block_arrival::arrival_size_min;
+size_t constexpr chratos::rep_crawler::recent_size;
+size_t constexpr chratos::handshake_verifier::max_batch;
+size_t constexpr chratos::handshake_verifier::max_queued;
+size_t constexpr chratos::confirmation_height_processor::batch_max;
+size_t constexpr chratos::confirmation_height_processor::max_queued;
+size_t constexpr chratos::peer_container::syn_cookie_shards_count;
+std::chrono::seconds constexpr chratos::syn_cookie_shard::bucket_interval;
 std::chrono::seconds constexpr chratos::block_arrival::arrival_time_min;
+size_t constexpr chratos::vote_reuse::votes_max;
 
 chratos::endpoint chratos::map_endpoint_to_v6 (chratos::endpoint const & endpoint_a)
 {
@@ -47,7 +62,8 @@ chratos::network::network (chratos::node & node_a, uint16_t port) :
 socket (node_a.service, chratos::endpoint (boost::asio::ip::address_v6::any (), port)),
 resolver (node_a.service),
 node (node_a),
-on (true)
+on (true),
+merge_scheduled (false)
 {
 }
 
@@ -72,7 +88,12 @@ void chratos::network::stop ()
 
 void chratos::network::send_keepalive (chratos::endpoint const & endpoint_a)
 {
-  assert (endpoint_a.address ().is_v6 ());
+  std::vector<chratos::endpoint> endpoints (1, endpoint_a);
+  send_keepalives (endpoints);
+}
+
+void chratos::network::send_keepalives (std::vector<chratos::endpoint> const & endpoints_a)
+{
   chratos::keepalive message;
   node.peers.random_fill (message.peers);
   std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
@@ -80,24 +101,28 @@ void chratos::network::send_keepalive (chratos::endpoint const & endpoint_a)
     chratos::vectorstream stream (*bytes);
     message.serialize (stream);
   }
-  if (node.config.logging.network_keepalive_logging ())
-  {
-    BOOST_LOG (node.log) << boost::str (boost::format ("Keepalive req sent to %1%") % endpoint_a);
-  }
   std::weak_ptr<chratos::node> node_w (node.shared ());
-  send_buffer (bytes->data (), bytes->size (), endpoint_a, [bytes, node_w, endpoint_a](boost::system::error_code const & ec, size_t) {
-    if (auto node_l = node_w.lock ())
+  for (auto & endpoint_a : endpoints_a)
+  {
+    assert (endpoint_a.address ().is_v6 ());
+    if (node.config.logging.network_keepalive_logging ())
     {
-      if (ec && node_l->config.logging.network_keepalive_logging ())
-      {
-        BOOST_LOG (node_l->log) << boost::str (boost::format ("Error sending keepalive to %1%: %2%") % endpoint_a % ec.message ());
-      }
-      else
+      BOOST_LOG (node.log) << boost::str (boost::format ("Keepalive req sent to %1%") % endpoint_a);
+    }
+    send_buffer (bytes->data (), bytes->size (), endpoint_a, [bytes, node_w, endpoint_a](boost::system::error_code const & ec, size_t) {
+      if (auto node_l = node_w.lock ())
       {
-        node_l->stats.inc (chratos::stat::type::message, chratos::stat::detail::keepalive, chratos::stat::dir::out);
+        if (ec && node_l->config.logging.network_keepalive_logging ())
+        {
+          BOOST_LOG (node_l->log) << boost::str (boost::format ("Error sending keepalive to %1%: %2%") % endpoint_a % ec.message ());
+        }
+        else
+        {
+          node_l->stats.inc (chratos::stat::type::message, chratos::stat::detail::keepalive, chratos::stat::dir::out);
+        }
       }
-    }
-  });
+    });
+  }
 }
 
 void chratos::node::keepalive (std::string const & address_a, uint16_t port_a)
@@ -178,15 +203,24 @@ bool confirm_block (MDB_txn * transaction_a, chratos::node & node_a, T & list_a,
   bool result (false);
   if (node_a.config.enable_voting)
   {
-    node_a.wallets.foreach_representative (transaction_a, [&result, &block_a, &list_a, &node_a, &transaction_a](chratos::public_key const & pub_a, chratos::raw_key const & prv_a) {
+    auto hash (block_a->hash ());
+    node_a.wallets.foreach_representative (transaction_a, [&result, &block_a, &hash, &list_a, &node_a, &transaction_a](chratos::public_key const & pub_a, chratos::expanded_key const & prv_a) {
       result = true;
-      auto vote (node_a.store.vote_generate (transaction_a, pub_a, prv_a, block_a));
-      chratos::confirm_ack confirm (vote);
-      std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
+      // A vote signed moments ago for the same block is re-sent rather than signing and storing a new sequence
+      std::shared_ptr<chratos::vote> vote;
+      std::shared_ptr<std::vector<uint8_t>> bytes;
+      if (node_a.vote_reuse.find (pub_a, hash, vote, bytes))
       {
-        chratos::vectorstream stream (*bytes);
-        confirm.serialize (stream);
+        vote = node_a.store.vote_generate (transaction_a, pub_a, prv_a, block_a);
+        chratos::confirm_ack confirm (vote);
+        bytes = std::make_shared<std::vector<uint8_t>> ();
+        {
+          chratos::vectorstream stream (*bytes);
+          confirm.serialize (stream);
+        }
+        node_a.vote_reuse.insert (vote, bytes);
       }
+      chratos::confirm_ack confirm (vote);
       for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
       {
         node_a.network.confirm_send (confirm, bytes, *j);
@@ -324,8 +358,16 @@ void chratos::network::send_confirm_req (chratos::endpoint const & endpoint_a, s
 template <typename T>
 void rep_query (chratos::node & node_a, T const & peers_a)
 {
-  chratos::transaction transaction (node_a.store.environment, nullptr, false);
-  std::shared_ptr<chratos::block> block (node_a.store.block_random (transaction));
+  std::shared_ptr<chratos::block> block;
+  if (node_a.config.rep_crawl_recent_confirmed)
+  {
+    block = node_a.rep_crawler.recent_block ();
+  }
+  if (block == nullptr)
+  {
+    chratos::transaction transaction (node_a.store.environment, nullptr, false);
+    block = node_a.store.block_random (transaction);
+  }
   auto hash (block->hash ());
   node_a.rep_crawler.add (hash);
   for (auto i (peers_a.begin ()), n (peers_a.end ()); i != n; ++i)
@@ -342,14 +384,6 @@ void rep_query (chratos::node & node_a, T const & peers_a)
   });
 }
 
-template <>
-void rep_query (chratos::node & node_a, chratos::endpoint const & peers_a)
-{
-  std::array<chratos::endpoint, 1> peers;
-  peers[0] = peers_a;
-  rep_query (node_a, peers);
-}
-
 namespace
 {
 class network_message_visitor : public chratos::message_visitor
@@ -460,23 +494,12 @@ public:
     {
       out_respond_to = message_a.query;
     }
-    auto validated_response (false);
     if (message_a.response)
     {
-      if (!node.peers.validate_syn_cookie (endpoint_l, message_a.response->first, message_a.response->second))
-      {
-        validated_response = true;
-        if (message_a.response->first != node.node_id.pub)
-        {
-          node.peers.insert (endpoint_l, message_a.header.version_using);
-        }
-      }
-      else if (node.config.logging.network_node_id_handshake_logging ())
-      {
-        BOOST_LOG (node.log) << boost::str (boost::format ("Failed to validate syn cookie signature %1% by %2%") % message_a.response->second.to_string () % message_a.response->first.to_account ());
-      }
+      // The verifier inserts the peer once the signature checks out, or queries it again if it doesn't
+      node.handshake_verifier.add (endpoint_l, message_a.response->first, message_a.response->second, message_a.header.version_using);
     }
-    if (!validated_response && !node.peers.known_peer (endpoint_l))
+    else if (!node.peers.known_peer (endpoint_l))
     {
       out_query = node.peers.assign_syn_cookie (endpoint_l);
     }
@@ -602,12 +625,41 @@ void chratos::network::receive_action (boost::system::error_code const & error,
 // Send keepalives to all the peers we've been notified of
 void chratos::network::merge_peers (std::array<chratos::endpoint, 8> const & peers_a)
 {
-  for (auto i (peers_a.begin ()), j (peers_a.end ()); i != j; ++i)
+  auto schedule (false);
   {
-    if (!node.peers.reachout (*i))
+    std::lock_guard<std::mutex> lock (merge_mutex);
+    for (auto i (peers_a.begin ()), j (peers_a.end ()); i != j && merge_candidates.size () < merge_peers_max; ++i)
     {
-      send_keepalive (*i);
+      merge_candidates.insert (*i);
     }
+    schedule = !merge_scheduled;
+    merge_scheduled = true;
+  }
+  if (schedule)
+  {
+    std::weak_ptr<chratos::node> node_w (node.shared ());
+    node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (merge_peers_interval_ms), [node_w]() {
+      if (auto node_l = node_w.lock ())
+      {
+        node_l->network.merge_peers_flush ();
+      }
+    });
+  }
+}
+
+void chratos::network::merge_peers_flush ()
+{
+  std::vector<chratos::endpoint> candidates;
+  {
+    std::lock_guard<std::mutex> lock (merge_mutex);
+    candidates.assign (merge_candidates.begin (), merge_candidates.end ());
+    merge_candidates.clear ();
+    merge_scheduled = false;
+  }
+  auto targets (node.peers.reachout_many (candidates));
+  if (!targets.empty ())
+  {
+    send_keepalives (targets);
   }
 }
 
@@ -910,7 +962,11 @@ enable_voting (true),
 bootstrap_connections (4),
 bootstrap_connections_max (64),
 callback_port (0),
-lmdb_max_dbs (128)
+lmdb_max_dbs (128),
+rep_crawl_recent_confirmed (true),
+peer_weight_verification_interval (0),
+send_id_retention (24 * 7),
+vote_reuse_window (5000)
 {
   const char * epoch_message ("epoch v1 block");
   strncpy ((char *)epoch_block_link.bytes.data (), epoch_message, epoch_block_link.bytes.size ());
@@ -940,7 +996,7 @@ lmdb_max_dbs (128)
 
 void chratos::node_config::serialize_json (boost::property_tree::ptree & tree_a) const
 {
-  tree_a.put ("version", "14");
+  tree_a.put ("version", "18");
   tree_a.put ("peering_port", std::to_string (peering_port));
   tree_a.put ("bootstrap_fraction_numerator", std::to_string (bootstrap_fraction_numerator));
   tree_a.put ("receive_minimum", receive_minimum.to_string_dec ());
@@ -984,6 +1040,10 @@ void chratos::node_config::serialize_json (boost::property_tree::ptree & tree_a)
   tree_a.put ("callback_target", callback_target);
   tree_a.put ("lmdb_max_dbs", lmdb_max_dbs);
   tree_a.put ("generate_hash_votes_at", std::chrono::system_clock::to_time_t (generate_hash_votes_at));
+  tree_a.put ("rep_crawl_recent_confirmed", rep_crawl_recent_confirmed);
+  tree_a.put ("peer_weight_verification_interval", std::to_string (peer_weight_verification_interval));
+  tree_a.put ("send_id_retention", std::to_string (send_id_retention));
+  tree_a.put ("vote_reuse_window", std::to_string (vote_reuse_window));
 }
 
 bool chratos::node_config::upgrade_json (unsigned version, boost::property_tree::ptree & tree_a)
@@ -1091,6 +1151,26 @@ bool chratos::node_config::upgrade_json (unsigned version, boost::property_tree:
       tree_a.put ("version", "14");
       result = true;
     case 14:
+      tree_a.put ("rep_crawl_recent_confirmed", rep_crawl_recent_confirmed);
+      tree_a.erase ("version");
+      tree_a.put ("version", "15");
+      result = true;
+    case 15:
+      tree_a.put ("peer_weight_verification_interval", std::to_string (peer_weight_verification_interval));
+      tree_a.erase ("version");
+      tree_a.put ("version", "16");
+      result = true;
+    case 16:
+      tree_a.put ("send_id_retention", std::to_string (send_id_retention));
+      tree_a.erase ("version");
+      tree_a.put ("version", "17");
+      result = true;
+    case 17:
+      tree_a.put ("vote_reuse_window", std::to_string (vote_reuse_window));
+      tree_a.erase ("version");
+      tree_a.put ("version", "18");
+      result = true;
+    case 18:
       break;
     default:
       throw std::runtime_error ("Unknown node_config version");
@@ -1178,6 +1258,10 @@ bool chratos::node_config::deserialize_json (bool & upgraded_a, boost::property_
     result |= parse_port (callback_port_l, callback_port);
     auto generate_hash_votes_at_l = tree_a.get<time_t> ("generate_hash_votes_at");
     generate_hash_votes_at = std::chrono::system_clock::from_time_t (generate_hash_votes_at_l);
+    rep_crawl_recent_confirmed = tree_a.get<bool> ("rep_crawl_recent_confirmed");
+    auto peer_weight_verification_interval_l (tree_a.get<std::string> ("peer_weight_verification_interval"));
+    auto send_id_retention_l (tree_a.get<std::string> ("send_id_retention"));
+    auto vote_reuse_window_l (tree_a.get<std::string> ("vote_reuse_window"));
     try
     {
       peering_port = std::stoul (peering_port_l);
@@ -1189,6 +1273,9 @@ bool chratos::node_config::deserialize_json (bool & upgraded_a, boost::property_
       bootstrap_connections_max = std::stoul (bootstrap_connections_max_l);
       lmdb_max_dbs = std::stoi (lmdb_max_dbs_l);
       online_weight_quorum = std::stoul (online_weight_quorum_l);
+      peer_weight_verification_interval = std::stoul (peer_weight_verification_interval_l);
+      send_id_retention = std::stoul (send_id_retention_l);
+      vote_reuse_window = std::stoul (vote_reuse_window_l);
       result |= peering_port > std::numeric_limits<uint16_t>::max ();
       result |= logging.deserialize_json (upgraded_a, logging_l);
       result |= receive_minimum.decode_dec (receive_minimum_l);
@@ -1353,6 +1440,228 @@ void chratos::vote_processor::flush ()
   }
 }
 
+chratos::handshake_verifier::handshake_verifier (chratos::node & node_a) :
+node (node_a),
+started (false),
+stopped (false),
+thread ([this]() { process_loop (); })
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  while (!started)
+  {
+    condition.wait (lock);
+  }
+}
+
+void chratos::handshake_verifier::process_loop ()
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  started = true;
+  condition.notify_all ();
+  while (!stopped)
+  {
+    if (!responses.empty ())
+    {
+      std::deque<response> responses_l;
+      if (responses.size () <= max_batch)
+      {
+        responses_l.swap (responses);
+      }
+      else
+      {
+        responses_l.assign (responses.begin (), responses.begin () + max_batch);
+        responses.erase (responses.begin (), responses.begin () + max_batch);
+      }
+      lock.unlock ();
+      verify_batch (responses_l);
+      lock.lock ();
+    }
+    else
+    {
+      condition.wait (lock);
+    }
+  }
+}
+
+void chratos::handshake_verifier::add (chratos::endpoint const & endpoint_a, chratos::account const & node_id_a, chratos::signature const & signature_a, unsigned version_a)
+{
+  assert (endpoint_a.address ().is_v6 ());
+  std::lock_guard<std::mutex> lock (mutex);
+  if (!stopped)
+  {
+    if (responses.size () < max_queued)
+    {
+      responses.push_back (response{ endpoint_a, node_id_a, signature_a, version_a });
+      condition.notify_all ();
+    }
+    else if (node.config.logging.network_node_id_handshake_logging ())
+    {
+      BOOST_LOG (node.log) << boost::str (boost::format ("Dropping node_id_handshake response from %1%, verification queue is full") % endpoint_a);
+    }
+  }
+}
+
+void chratos::handshake_verifier::verify_batch (std::deque<response> const & responses_a)
+{
+  auto size (responses_a.size ());
+  std::vector<boost::optional<chratos::uint256_union>> cookies;
+  cookies.reserve (size);
+  std::vector<unsigned char const *> messages;
+  std::vector<size_t> lengths;
+  std::vector<unsigned char const *> pub_keys;
+  std::vector<unsigned char const *> signatures;
+  std::vector<size_t> indices;
+  for (size_t i (0); i < size; ++i)
+  {
+    auto & response_l (responses_a[i]);
+    cookies.push_back (node.peers.syn_cookie (response_l.endpoint));
+    if (cookies.back ())
+    {
+      messages.push_back (cookies.back ()->bytes.data ());
+      lengths.push_back (sizeof (cookies.back ()->bytes));
+      pub_keys.push_back (response_l.node_id.bytes.data ());
+      signatures.push_back (response_l.signature.bytes.data ());
+      indices.push_back (i);
+    }
+  }
+  std::vector<int> verified (size, 0);
+  if (!indices.empty ())
+  {
+    std::vector<int> valid (indices.size (), 0);
+    chratos::validate_message_batch (messages.data (), lengths.data (), pub_keys.data (), signatures.data (), indices.size (), valid.data ());
+    for (size_t i (0); i < indices.size (); ++i)
+    {
+      verified[indices[i]] = valid[i];
+    }
+  }
+  for (size_t i (0); i < size; ++i)
+  {
+    auto & response_l (responses_a[i]);
+    if (verified[i] == 1 && !node.peers.erase_syn_cookie (response_l.endpoint, *cookies[i]))
+    {
+      if (response_l.node_id != node.node_id.pub)
+      {
+        node.peers.insert (response_l.endpoint, response_l.version, response_l.node_id);
+      }
+    }
+    else
+    {
+      if (node.config.logging.network_node_id_handshake_logging ())
+      {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Failed to validate syn cookie signature %1% by %2%") % response_l.signature.to_string () % response_l.node_id.to_account ());
+      }
+      if (!node.peers.known_peer (response_l.endpoint))
+      {
+        auto query (node.peers.assign_syn_cookie (response_l.endpoint));
+        if (query)
+        {
+          node.network.send_node_id_handshake (response_l.endpoint, query, boost::none);
+        }
+      }
+    }
+  }
+}
+
+void chratos::handshake_verifier::stop ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped = true;
+    condition.notify_all ();
+  }
+  if (thread.joinable ())
+  {
+    thread.join ();
+  }
+}
+
+chratos::confirmation_height_processor::confirmation_height_processor (chratos::node & node_a) :
+node (node_a),
+started (false),
+stopped (false),
+active (false),
+thread ([this]() { process_loop (); })
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  while (!started)
+  {
+    condition.wait (lock);
+  }
+}
+
+void chratos::confirmation_height_processor::process_loop ()
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  started = true;
+  condition.notify_all ();
+  while (!stopped)
+  {
+    if (!hashes.empty ())
+    {
+      auto hash (hashes.front ());
+      hashes.pop_front ();
+      active = true;
+      lock.unlock ();
+      cement (hash);
+      lock.lock ();
+      active = false;
+      condition.notify_all ();
+    }
+    else
+    {
+      condition.wait (lock);
+    }
+  }
+}
+
+void chratos::confirmation_height_processor::add (chratos::block_hash const & hash_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  // Cementing a block cements its ancestors too, a dropped hash is picked up by the next confirmation on the same chain
+  if (!stopped && hashes.size () < max_queued)
+  {
+    hashes.push_back (hash_a);
+    condition.notify_all ();
+  }
+}
+
+void chratos::confirmation_height_processor::cement (chratos::block_hash const & hash_a)
+{
+  chratos::confirmation_job job (hash_a);
+  auto stopped_l (false);
+  while (!job.done () && !stopped_l)
+  {
+    {
+      chratos::transaction transaction (node.store.environment, nullptr, true);
+      node.ledger.confirm (transaction, job, batch_max);
+    }
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped_l = stopped;
+  }
+}
+
+void chratos::confirmation_height_processor::stop ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped = true;
+    condition.notify_all ();
+  }
+  if (thread.joinable ())
+  {
+    thread.join ();
+  }
+}
+
+void chratos::confirmation_height_processor::flush ()
+{
+  std::unique_lock<std::mutex> lock (mutex);
+  while (active || !hashes.empty ())
+  {
+    condition.wait (lock);
+  }
+}
+
 void chratos::rep_crawler::add (chratos::block_hash const & hash_a)
 {
   std::lock_guard<std::mutex> lock (mutex);
@@ -1362,7 +1671,12 @@ void chratos::rep_crawler::add (chratos::block_hash const & hash_a)
 void chratos::rep_crawler::remove (chratos::block_hash const & hash_a)
 {
   std::lock_guard<std::mutex> lock (mutex);
-  active.erase (hash_a);
+  // The same recent block can be in flight for several batches, only drop this query's entry
+  auto existing (active.find (hash_a));
+  if (existing != active.end ())
+  {
+    active.erase (existing);
+  }
 }
 
 bool chratos::rep_crawler::exists (chratos::block_hash const & hash_a)
@@ -1371,6 +1685,42 @@ bool chratos::rep_crawler::exists (chratos::block_hash const & hash_a)
   return active.count (hash_a) != 0;
 }
 
+void chratos::rep_crawler::observe (std::shared_ptr<chratos::block> block_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  recent.push_back (block_a);
+  if (recent.size () > recent_size)
+  {
+    recent.pop_front ();
+  }
+}
+
+std::shared_ptr<chratos::block> chratos::rep_crawler::recent_block ()
+{
+  std::shared_ptr<chratos::block> result;
+  std::lock_guard<std::mutex> lock (mutex);
+  if (!recent.empty ())
+  {
+    result = recent[chratos::random_pool.GenerateWord32 (0, recent.size () - 1)];
+  }
+  return result;
+}
+
+void chratos::rep_crawler::queue (chratos::endpoint const & endpoint_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  queued.insert (endpoint_a);
+}
+
+std::vector<chratos::endpoint> chratos::rep_crawler::take_queued ()
+{
+  std::vector<chratos::endpoint> result;
+  std::lock_guard<std::mutex> lock (mutex);
+  result.assign (queued.begin (), queued.end ());
+  queued.clear ();
+  return result;
+}
+
 chratos::block_processor::block_processor (chratos::node & node_a) :
 stopped (false),
 active (false),
@@ -1386,15 +1736,20 @@ chratos::block_processor::~block_processor ()
 
 void chratos::block_processor::stop ()
 {
-  std::lock_guard<std::mutex> lock (mutex);
-  stopped = true;
-  condition.notify_all ();
+  std::unordered_multimap<chratos::block_hash, std::function<void(chratos::process_return const &)>> completions_l;
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stopped = true;
+    completions_l.swap (completions);
+    condition.notify_all ();
+  }
+  // Pending completions are dropped without being called, waiters see their promise broken
 }
 
 void chratos::block_processor::flush ()
 {
   std::unique_lock<std::mutex> lock (mutex);
-  while (!stopped && (!blocks.empty () || active))
+  while (!stopped && (!blocks.empty () || !local.empty () || active))
   {
     condition.wait (lock);
   }
@@ -1425,13 +1780,56 @@ void chratos::block_processor::add (std::shared_ptr<chratos::block> block_a, std
   }
 }
 
-void chratos::block_processor::force (std::shared_ptr<chratos::block> block_a)
+void chratos::block_processor::add (std::shared_ptr<chratos::block> block_a, std::chrono::steady_clock::time_point origination, std::function<void(chratos::process_return const &)> completion_a)
 {
-  std::lock_guard<std::mutex> lock (mutex);
-  forced.push_back (block_a);
-  condition.notify_all ();
-}
-
+  if (!chratos::work_validate (block_a->root (), block_a->block_work ()))
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    if (!stopped)
+    {
+      completions.insert (std::make_pair (block_a->hash (), std::move (completion_a)));
+      // Locally submitted blocks go ahead of whatever the network has queued so their callers aren't waiting on a bootstrap backlog
+      local.push_back (std::make_pair (block_a, origination));
+      condition.notify_all ();
+    }
+  }
+  else
+  {
+    // The block is never queued so nothing would complete it later
+    chratos::process_return result;
+    result.code = chratos::process_result::insufficient_work;
+    completion_a (result);
+  }
+}
+
+void chratos::block_processor::complete (std::vector<std::pair<chratos::block_hash, chratos::process_return>> const & processed_a)
+{
+  std::vector<std::pair<std::function<void(chratos::process_return const &)>, chratos::process_return>> ready;
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    for (auto & i : processed_a)
+    {
+      auto existing (completions.equal_range (i.first));
+      for (auto j (existing.first); j != existing.second; ++j)
+      {
+        ready.push_back (std::make_pair (std::move (j->second), i.second));
+      }
+      completions.erase (existing.first, existing.second);
+    }
+  }
+  for (auto & i : ready)
+  {
+    i.first (i.second);
+  }
+}
+
+void chratos::block_processor::force (std::shared_ptr<chratos::block> block_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  forced.push_back (block_a);
+  condition.notify_all ();
+}
+
 void chratos::block_processor::process_blocks ()
 {
   std::unique_lock<std::mutex> lock (mutex);
@@ -1468,17 +1866,20 @@ bool chratos::block_processor::should_log ()
 bool chratos::block_processor::have_blocks ()
 {
   assert (!mutex.try_lock ());
-  return !blocks.empty () || !forced.empty ();
+  return !blocks.empty () || !local.empty () || !forced.empty ();
 }
 
 void chratos::block_processor::process_receive_many (std::unique_lock<std::mutex> & lock_a)
 {
+  std::vector<std::pair<chratos::block_hash, chratos::process_return>> processed;
   {
     chratos::transaction transaction (node.store.environment, nullptr, true);
     auto cutoff (std::chrono::steady_clock::now () + chratos::transaction_timeout);
     lock_a.lock ();
     auto count (0);
-    while (have_blocks () && count < 16384)
+    auto local_taken (false);
+    // Commit as soon as the local blocks are done so their completions don't wait for the rest of a full batch
+    while (have_blocks () && count < 16384 && !(local_taken && local.empty ()))
     {
       if (blocks.size () > 64 && should_log ())
       {
@@ -1486,7 +1887,13 @@ void chratos::block_processor::process_receive_many (std::unique_lock<std::mutex
       }
       std::pair<std::shared_ptr<chratos::block>, std::chrono::steady_clock::time_point> block;
       bool force (false);
-      if (forced.empty ())
+      if (forced.empty () && !local.empty ())
+      {
+        block = local.front ();
+        local.pop_front ();
+        local_taken = true;
+      }
+      else if (forced.empty ())
       {
         block = blocks.front ();
         blocks.pop_front ();
@@ -1511,12 +1918,19 @@ void chratos::block_processor::process_receive_many (std::unique_lock<std::mutex
         }
       }
       auto process_result (process_receive_one (transaction, block.first, block.second));
-      (void)process_result;
       lock_a.lock ();
+      if (completions.find (hash) != completions.end ())
+      {
+        processed.push_back (std::make_pair (hash, process_result));
+      }
       ++count;
     }
   }
   lock_a.unlock ();
+  if (!processed.empty ())
+  {
+    complete (processed);
+  }
 }
 
 chratos::process_return chratos::block_processor::process_receive_one (MDB_txn * transaction_a, std::shared_ptr<chratos::block> block_a, std::chrono::steady_clock::time_point origination)
@@ -1682,6 +2096,12 @@ chratos::process_return chratos::block_processor::process_receive_one (MDB_txn *
       }
       break;
     }
+    case chratos::process_result::insufficient_work:
+    {
+      // Only reported by block_processor::add, the ledger never returns it
+      assert (false);
+      break;
+    }
   }
   return result;
 }
@@ -1708,6 +2128,7 @@ service (service_a),
 config (config_a),
 alarm (alarm_a),
 work (work_a),
+startup (log),
 store (init_a.block_store_init, application_path_a / "data.ldb", config_a.lmdb_max_dbs),
 gap_cache (*this),
 ledger (store, stats, config.epoch_block_link, config.epoch_block_signer),
@@ -1720,11 +2141,16 @@ application_path (application_path_a),
 wallets (init_a.block_store_init, *this),
 port_mapping (*this),
 vote_processor (*this),
+handshake_verifier (*this),
+confirmation_heights (*this),
 warmed_up (0),
 block_processor (*this),
 block_processor_thread ([this]() { this->block_processor.process_blocks (); }),
+vote_reuse (std::chrono::milliseconds (config.vote_reuse_window)),
 online_reps (*this),
-stats (config.stat_config)
+stats (config.stat_config),
+unchecked_clearing (false),
+started (false)
 {
   wallets.observer = [this](bool active) {
     observers.wallet.notify (active);
@@ -1841,7 +2267,7 @@ stats (config.stat_config)
   });
   observers.endpoint.add ([this](chratos::endpoint const & endpoint_a) {
     this->network.send_keepalive (endpoint_a);
-    rep_query (*this, endpoint_a);
+    this->rep_crawler.queue (endpoint_a);
   });
   observers.vote.add ([this](std::shared_ptr<chratos::vote> vote_a, chratos::endpoint const & endpoint_a) {
     assert (endpoint_a.address ().is_v6 ());
@@ -1884,6 +2310,7 @@ stats (config.stat_config)
       }
     }
   });
+  startup.phase ("node_services");
   BOOST_LOG (log) << "Node starting, version: " << RAIBLOCKS_VERSION_MAJOR << "." << RAIBLOCKS_VERSION_MINOR;
   BOOST_LOG (log) << boost::str (boost::format ("Work pool running %1% threads") % work.threads.size ());
   if (!init_a.error ())
@@ -1902,6 +2329,7 @@ stats (config.stat_config)
     node_id = chratos::keypair (store.get_node_id (transaction));
     BOOST_LOG (log) << "Node ID: " << node_id.pub.to_account ();
   }
+  startup.phase ("ledger_init");
   peers.online_weight_minimum = config.online_weight_minimum.number ();
   if (chratos::chratos_network == chratos::chratos_networks::chratos_live_network)
   {
@@ -1933,6 +2361,7 @@ stats (config.stat_config)
         }
       }
     }
+    startup.phase ("bootstrap_weights");
   }
 }
 
@@ -1962,7 +2391,8 @@ void chratos::node::process_fork (MDB_txn * transaction_a, std::shared_ptr<chrat
   if (!store.block_exists (transaction_a, block_a->hash ()) && store.root_exists (transaction_a, block_a->root ()))
   {
     std::shared_ptr<chratos::block> ledger_block (ledger.forked_block (transaction_a, *block_a));
-    if (ledger_block)
+    // Cemented blocks are final, forks against them aren't worth an election
+    if (ledger_block && ledger.block_confirmed (transaction_a, ledger_block->hash ()) != chratos::confirmation_status::confirmed)
     {
       std::weak_ptr<chratos::node> this_w (shared_from_this ());
       if (!active.start (std::make_pair (ledger_block, block_a), [this_w, root](std::shared_ptr<chratos::block>) {
@@ -2117,6 +2547,53 @@ void chratos::node::process_active (std::shared_ptr<chratos::block> incoming)
   }
 }
 
+bool chratos::node::process_local (std::shared_ptr<chratos::block> block_a, chratos::process_return & result_a)
+{
+  auto result (false);
+  block_arrival.add (block_a->hash ());
+  auto promise (std::make_shared<std::promise<chratos::process_return>> ());
+  auto future (promise->get_future ());
+  block_processor.add (block_a, std::chrono::steady_clock::now (), [promise](chratos::process_return const & result_a) {
+    promise->set_value (result_a);
+  });
+  try
+  {
+    result_a = future.get ();
+  }
+  catch (std::future_error const &)
+  {
+    result = true;
+  }
+  return result;
+}
+
+bool chratos::node::process_local (std::vector<std::shared_ptr<chratos::block>> const & blocks_a, std::vector<chratos::process_return> & results_a)
+{
+  auto result (false);
+  std::vector<std::future<chratos::process_return>> futures;
+  for (auto & i : blocks_a)
+  {
+    block_arrival.add (i->hash ());
+    auto promise (std::make_shared<std::promise<chratos::process_return>> ());
+    futures.push_back (promise->get_future ());
+    block_processor.add (i, std::chrono::steady_clock::now (), [promise](chratos::process_return const & result_a) {
+      promise->set_value (result_a);
+    });
+  }
+  for (auto i (futures.begin ()), n (futures.end ()); i != n && !result; ++i)
+  {
+    try
+    {
+      results_a.push_back (i->get ());
+    }
+    catch (std::future_error const &)
+    {
+      result = true;
+    }
+  }
+  return result;
+}
+
 chratos::process_return chratos::node::process (chratos::block const & block_a)
 {
   chratos::transaction transaction (store.environment, nullptr, true);
@@ -2194,48 +2671,128 @@ chratos::endpoint chratos::peer_container::bootstrap_peer ()
   return result;
 }
 
-boost::optional<chratos::uint256_union> chratos::peer_container::assign_syn_cookie (chratos::endpoint const & endpoint)
+boost::optional<chratos::uint256_union> chratos::syn_cookie_shard::assign (chratos::endpoint const & endpoint, size_t max_per_ip)
 {
   auto ip_addr (endpoint.address ());
   assert (ip_addr.is_v6 ());
-  std::unique_lock<std::mutex> lock (syn_cookie_mutex);
-  unsigned & ip_cookies = syn_cookies_per_ip[ip_addr];
+  std::lock_guard<std::mutex> lock (mutex);
+  unsigned & ip_cookies = cookies_per_ip[ip_addr];
   boost::optional<chratos::uint256_union> result;
-  if (ip_cookies < max_peers_per_ip)
+  if (ip_cookies < max_per_ip)
   {
-    if (syn_cookies.find (endpoint) == syn_cookies.end ())
+    if (cookies.find (endpoint) == cookies.end ())
     {
       chratos::uint256_union query;
       random_pool.GenerateBlock (query.bytes.data (), query.bytes.size ());
-      syn_cookie_info info{ query, std::chrono::steady_clock::now () };
-      syn_cookies[endpoint] = info;
+      auto now (std::chrono::steady_clock::now ());
+      syn_cookie_info info{ query, now };
+      cookies[endpoint] = info;
       ++ip_cookies;
+      if (buckets.empty () || buckets.back ().first + bucket_interval <= now)
+      {
+        buckets.emplace_back (now, std::vector<chratos::endpoint> ());
+      }
+      buckets.back ().second.push_back (endpoint);
       result = query;
     }
   }
   return result;
 }
 
-bool chratos::peer_container::validate_syn_cookie (chratos::endpoint const & endpoint, chratos::account node_id, chratos::signature sig)
+boost::optional<chratos::uint256_union> chratos::syn_cookie_shard::cookie (chratos::endpoint const & endpoint)
 {
-  auto ip_addr (endpoint.address ());
-  assert (ip_addr.is_v6 ());
-  std::unique_lock<std::mutex> lock (syn_cookie_mutex);
+  std::lock_guard<std::mutex> lock (mutex);
+  boost::optional<chratos::uint256_union> result;
+  auto cookie_it (cookies.find (endpoint));
+  if (cookie_it != cookies.end ())
+  {
+    result = cookie_it->second.cookie;
+  }
+  return result;
+}
+
+bool chratos::syn_cookie_shard::erase (chratos::endpoint const & endpoint, chratos::uint256_union const & cookie_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
   auto result (true);
-  auto cookie_it (syn_cookies.find (endpoint));
-  if (cookie_it != syn_cookies.end () && !chratos::validate_message (node_id, cookie_it->second.cookie, sig))
+  auto cookie_it (cookies.find (endpoint));
+  if (cookie_it != cookies.end () && cookie_it->second.cookie == cookie_a)
   {
     result = false;
-    syn_cookies.erase (cookie_it);
-    unsigned & ip_cookies = syn_cookies_per_ip[ip_addr];
-    if (ip_cookies > 0)
+    erase_locked (cookie_it);
+  }
+  return result;
+}
+
+void chratos::syn_cookie_shard::erase_locked (std::unordered_map<chratos::endpoint, syn_cookie_info>::iterator cookie_it)
+{
+  auto per_ip (cookies_per_ip.find (cookie_it->first.address ()));
+  if (per_ip != cookies_per_ip.end () && per_ip->second > 0)
+  {
+    if (--per_ip->second == 0)
     {
-      --ip_cookies;
+      cookies_per_ip.erase (per_ip);
     }
-    else
+  }
+  else
+  {
+    assert (false && "More SYN cookies deleted than created for IP");
+  }
+  cookies.erase (cookie_it);
+}
+
+void chratos::syn_cookie_shard::purge (std::chrono::steady_clock::time_point const & cutoff)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  // Every cookie filed in a bucket which ended before the cutoff has expired unless its endpoint was since validated and assigned a newer one
+  while (!buckets.empty () && buckets.front ().first + bucket_interval <= cutoff)
+  {
+    for (auto & endpoint : buckets.front ().second)
     {
-      assert (false && "More SYN cookies deleted than created for IP");
+      auto cookie_it (cookies.find (endpoint));
+      if (cookie_it != cookies.end () && cookie_it->second.created_at < cutoff)
+      {
+        erase_locked (cookie_it);
+      }
     }
+    buckets.pop_front ();
+  }
+}
+
+size_t chratos::syn_cookie_shard::size ()
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return cookies.size ();
+}
+
+chratos::syn_cookie_shard & chratos::peer_container::syn_cookie_shard_for (boost::asio::ip::address const & address_a)
+{
+  return syn_cookie_shards[std::hash<boost::asio::ip::address> () (address_a) % syn_cookie_shards_count];
+}
+
+boost::optional<chratos::uint256_union> chratos::peer_container::assign_syn_cookie (chratos::endpoint const & endpoint)
+{
+  return syn_cookie_shard_for (endpoint.address ()).assign (endpoint, max_peers_per_ip);
+}
+
+boost::optional<chratos::uint256_union> chratos::peer_container::syn_cookie (chratos::endpoint const & endpoint)
+{
+  return syn_cookie_shard_for (endpoint.address ()).cookie (endpoint);
+}
+
+bool chratos::peer_container::erase_syn_cookie (chratos::endpoint const & endpoint, chratos::uint256_union const & cookie)
+{
+  return syn_cookie_shard_for (endpoint.address ()).erase (endpoint, cookie);
+}
+
+bool chratos::peer_container::validate_syn_cookie (chratos::endpoint const & endpoint, chratos::account node_id, chratos::signature sig)
+{
+  assert (endpoint.address ().is_v6 ());
+  auto result (true);
+  auto cookie (syn_cookie (endpoint));
+  if (cookie && !chratos::validate_message (node_id, *cookie, sig))
+  {
+    result = erase_syn_cookie (endpoint, *cookie);
   }
   return result;
 }
@@ -2324,23 +2881,46 @@ bool chratos::parse_tcp_endpoint (std::string const & string, chratos::tcp_endpo
 
 void chratos::node::start ()
 {
+  // Closes out whatever the caller did between construction and start so it isn't counted as network setup
+  startup.phase ("pre_start");
+  started = true;
+  // Unlocking wallets is dominated by key derivation, let it run on the wallet action thread while the network comes up
+  wallets.enter_initial_passwords ();
   network.receive ();
+  bootstrap.start ();
+  port_mapping.start ();
+  startup.phase ("network");
+  restore_peers ();
+  add_initial_peers ();
+  startup.phase ("peers");
   ongoing_keepalive ();
   ongoing_syn_cookie_cleanup ();
   ongoing_bootstrap ();
   ongoing_store_flush ();
   ongoing_rep_crawl ();
-  bootstrap.start ();
+  ongoing_peer_snapshot ();
+  if (config.send_id_retention != 0)
+  {
+    ongoing_send_id_expiry ();
+  }
+  if (config.peer_weight_verification_interval != 0)
+  {
+    ongoing_peer_weight_verification ();
+  }
   backup_wallet ();
   online_reps.recalculate_stake ();
-  port_mapping.start ();
-  add_initial_peers ();
+  startup.phase ("scheduling");
   observers.started.notify ();
 }
 
 void chratos::node::stop ()
 {
   BOOST_LOG (log) << "Node stopping";
+  // Saved once on the first stop of a started node, stop runs again from the destructor and a node that never started has no peers worth keeping
+  if (started.exchange (false))
+  {
+    save_peers ();
+  }
   block_processor.stop ();
   if (block_processor_thread.joinable ())
   {
@@ -2352,6 +2932,8 @@ void chratos::node::stop ()
   bootstrap.stop ();
   port_mapping.stop ();
   vote_processor.stop ();
+  handshake_verifier.stop ();
+  confirmation_heights.stop ();
   wallets.stop ();
 }
 
@@ -2405,105 +2987,344 @@ chratos::account chratos::node::representative (chratos::account const & account
   {
     result = info.rep_block;
   }
-  return result;
+  return result;
+}
+
+void chratos::node::ongoing_keepalive ()
+{
+  keepalive_preconfigured (config.preconfigured_peers);
+  auto peers_l (peers.purge_list (std::chrono::steady_clock::now () - cutoff));
+  for (auto i (peers_l.begin ()), j (peers_l.end ()); i != j && std::chrono::steady_clock::now () - i->last_attempt > period; ++i)
+  {
+    network.send_keepalive (i->endpoint);
+  }
+  std::weak_ptr<chratos::node> node_w (shared_from_this ());
+  alarm.add (std::chrono::steady_clock::now () + period, [node_w]() {
+    if (auto node_l = node_w.lock ())
+    {
+      node_l->ongoing_keepalive ();
+    }
+  });
+}
+
+void chratos::node::ongoing_syn_cookie_cleanup ()
+{
+  peers.purge_syn_cookies (std::chrono::steady_clock::now () - syn_cookie_cutoff);
+  std::weak_ptr<chratos::node> node_w (shared_from_this ());
+  alarm.add (std::chrono::steady_clock::now () + (syn_cookie_cutoff * 2), [node_w]() {
+    if (auto node_l = node_w.lock ())
+    {
+      node_l->ongoing_syn_cookie_cleanup ();
+    }
+  });
+}
+
+void chratos::node::ongoing_rep_crawl ()
+{
+  auto now (std::chrono::steady_clock::now ());
+  auto peers_l (peers.rep_crawl ());
+  // Newly observed peers are probed in the same batch so the whole crawl shares a single target block
+  auto queued_l (rep_crawler.take_queued ());
+  peers_l.insert (peers_l.end (), queued_l.begin (), queued_l.end ());
+  if (!peers_l.empty ())
+  {
+    rep_query (*this, peers_l);
+  }
+  if (network.on)
+  {
+    std::weak_ptr<chratos::node> node_w (shared_from_this ());
+    alarm.add (now + std::chrono::seconds (4), [node_w]() {
+      if (auto node_l = node_w.lock ())
+      {
+        node_l->ongoing_rep_crawl ();
+      }
+    });
+  }
+}
+
+void chratos::node::ongoing_peer_weight_verification ()
+{
+  if (peers.verify_total_weight ())
+  {
+    BOOST_LOG (log) << "Cached peer weight had drifted from the peer table and was recomputed";
+  }
+  std::weak_ptr<chratos::node> node_w (shared_from_this ());
+  alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (config.peer_weight_verification_interval), [node_w]() {
+    if (auto node_l = node_w.lock ())
+    {
+      node_l->ongoing_peer_weight_verification ();
+    }
+  });
+}
+
+void chratos::node::ongoing_bootstrap ()
+{
+  auto next_wakeup (300);
+  if (warmed_up < 3)
+  {
+    // Re-attempt bootstrapping more aggressively on startup
+    next_wakeup = 5;
+    if (!bootstrap_initiator.in_progress () && !peers.empty ())
+    {
+      ++warmed_up;
+    }
+  }
+  bootstrap_initiator.bootstrap ();
+  std::weak_ptr<chratos::node> node_w (shared_from_this ());
+  alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (next_wakeup), [node_w]() {
+    if (auto node_l = node_w.lock ())
+    {
+      node_l->ongoing_bootstrap ();
+    }
+  });
+}
+
+void chratos::node::ongoing_store_flush ()
+{
+  {
+    chratos::transaction transaction (store.environment, nullptr, true);
+    store.flush (transaction);
+#ifndef NDEBUG
+    if (store.counts_verify (transaction))
+    {
+      BOOST_LOG (log) << "Cached block or account counts had drifted from the database and were reseeded";
+    }
+#endif
+  }
+  std::weak_ptr<chratos::node> node_w (shared_from_this ());
+  alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w]() {
+    if (auto node_l = node_w.lock ())
+    {
+      node_l->ongoing_store_flush ();
+    }
+  });
+}
+
+void chratos::node::backup_wallet ()
+{
+  chratos::transaction transaction (store.environment, nullptr, false);
+  for (auto i (wallets.items.begin ()), n (wallets.items.end ()); i != n; ++i)
+  {
+    auto backup_path (application_path / "backup");
+    boost::filesystem::create_directories (backup_path);
+    i->second->store.write_backup (transaction, backup_path / (i->first.to_string () + ".json"));
+  }
+  auto this_l (shared ());
+  alarm.add (std::chrono::steady_clock::now () + backup_interval, [this_l]() {
+    this_l->backup_wallet ();
+  });
+}
+
+void chratos::node::save_peers ()
+{
+  boost::property_tree::ptree tree;
+  tree.put ("saved", std::to_string (std::chrono::duration_cast<std::chrono::seconds> (std::chrono::system_clock::now ().time_since_epoch ()).count ()));
+  boost::property_tree::ptree peers_l;
+  for (auto & info : peers.list_vector ())
+  {
+    boost::property_tree::ptree entry;
+    entry.put ("endpoint", info.endpoint.address ().to_string () + ':' + std::to_string (info.endpoint.port ()));
+    entry.put ("version", std::to_string (info.network_version));
+    if (info.node_id)
+    {
+      entry.put ("node_id", info.node_id->to_account ());
+    }
+    if (!info.rep_weight.is_zero ())
+    {
+      entry.put ("rep_account", info.probable_rep_account.to_account ());
+      entry.put ("rep_weight", info.rep_weight.to_string_dec ());
+    }
+    peers_l.push_back (std::make_pair ("", entry));
+  }
+  tree.add_child ("peers", peers_l);
+  // Write to a temporary file first so a crash mid-write can't leave a truncated snapshot behind
+  auto path (application_path / "peers.json");
+  auto temporary (application_path / "peers.json.tmp");
+  boost::system::error_code ec;
+  {
+    std::ofstream stream (temporary.string ());
+    boost::property_tree::write_json (stream, tree);
+    if (stream.fail ())
+    {
+      ec = boost::system::errc::make_error_code (boost::system::errc::io_error);
+    }
+  }
+  if (!ec)
+  {
+    boost::filesystem::rename (temporary, path, ec);
+  }
+  if (ec)
+  {
+    BOOST_LOG (log) << boost::str (boost::format ("Unable to write peer snapshot %1%: %2%") % path.string () % ec.message ());
+  }
+}
+
+void chratos::node::restore_peers ()
+{
+  auto path (application_path / "peers.json");
+  if (boost::filesystem::exists (path))
+  {
+    std::vector<chratos::peer_information> restored;
+    try
+    {
+      boost::property_tree::ptree tree;
+      std::ifstream stream (path.string ());
+      boost::property_tree::read_json (stream, tree);
+      std::chrono::system_clock::time_point saved (std::chrono::seconds (std::stoull (tree.get<std::string> ("saved"))));
+      auto now (std::chrono::system_clock::now ());
+      if (saved > now)
+      {
+        // The clock was set back since the snapshot was written, there's no telling how old it is
+        BOOST_LOG (log) << boost::str (boost::format ("Ignoring peer snapshot %1% saved in the future") % path.string ());
+      }
+      else if (now - saved < peer_snapshot_cutoff)
+      {
+        // Restored peers only survive the next purge if they answer in the meantime
+        auto contact (std::chrono::steady_clock::now () - cutoff + period);
+        for (auto & i : tree.get_child ("peers"))
+        {
+          auto & entry (i.second);
+          chratos::endpoint endpoint;
+          auto error (chratos::parse_endpoint (entry.get<std::string> ("endpoint"), endpoint));
+          if (!error && !peers.not_a_peer (endpoint, false))
+          {
+            chratos::peer_information info (endpoint, contact, contact);
+            info.network_version = std::stoul (entry.get<std::string> ("version"));
+            auto node_id_l (entry.get_optional<std::string> ("node_id"));
+            if (node_id_l)
+            {
+              chratos::account node_id;
+              if (!node_id.decode_account (*node_id_l))
+              {
+                info.node_id = node_id;
+              }
+            }
+            auto rep_account_l (entry.get_optional<std::string> ("rep_account"));
+            auto rep_weight_l (entry.get_optional<std::string> ("rep_weight"));
+            if (rep_account_l && rep_weight_l)
+            {
+              chratos::account rep_account;
+              chratos::amount rep_weight;
+              if (!rep_account.decode_account (*rep_account_l) && !rep_weight.decode_dec (*rep_weight_l))
+              {
+                info.probable_rep_account = rep_account;
+                info.rep_weight = rep_weight;
+              }
+            }
+            if (info.network_version >= chratos::protocol_version_min)
+            {
+              restored.push_back (info);
+            }
+          }
+        }
+      }
+      else
+      {
+        BOOST_LOG (log) << boost::str (boost::format ("Ignoring peer snapshot %1% older than %2% minutes") % path.string () % std::chrono::duration_cast<std::chrono::minutes> (peer_snapshot_cutoff).count ());
+      }
+    }
+    catch (std::exception const & e)
+    {
+      BOOST_LOG (log) << boost::str (boost::format ("Unable to read peer snapshot %1%: %2%") % path.string () % e.what ());
+      restored.clear ();
+    }
+    if (!restored.empty ())
+    {
+      BOOST_LOG (log) << boost::str (boost::format ("Restoring %1% peers from snapshot") % restored.size ());
+      peers.restore (restored);
+      // Peers supporting node IDs are queried straight away, their weight is only trusted again once they answer with the same ID
+      std::vector<chratos::endpoint> endpoints;
+      for (auto & info : restored)
+      {
+        endpoints.push_back (info.endpoint);
+        if (info.network_version >= chratos::node_id_version)
+        {
+          auto cookie (peers.assign_syn_cookie (info.endpoint));
+          if (cookie)
+          {
+            network.send_node_id_handshake (info.endpoint, *cookie, boost::none);
+          }
+        }
+      }
+      network.send_keepalives (endpoints);
+    }
+  }
 }
 
-void chratos::node::ongoing_keepalive ()
+void chratos::node::ongoing_peer_snapshot ()
 {
-  keepalive_preconfigured (config.preconfigured_peers);
-  auto peers_l (peers.purge_list (std::chrono::steady_clock::now () - cutoff));
-  for (auto i (peers_l.begin ()), j (peers_l.end ()); i != j && std::chrono::steady_clock::now () - i->last_attempt > period; ++i)
-  {
-    network.send_keepalive (i->endpoint);
-  }
   std::weak_ptr<chratos::node> node_w (shared_from_this ());
-  alarm.add (std::chrono::steady_clock::now () + period, [node_w]() {
+  alarm.add (std::chrono::steady_clock::now () + peer_snapshot_interval, [node_w]() {
     if (auto node_l = node_w.lock ())
     {
-      node_l->ongoing_keepalive ();
+      node_l->save_peers ();
+      node_l->ongoing_peer_snapshot ();
     }
   });
 }
 
-void chratos::node::ongoing_syn_cookie_cleanup ()
+void chratos::node::ongoing_send_id_expiry ()
 {
-  peers.purge_syn_cookies (std::chrono::steady_clock::now () - syn_cookie_cutoff);
+  auto expired (wallets.expire_send_ids ());
+  if (expired != 0 && config.logging.ledger_logging ())
+  {
+    BOOST_LOG (log) << boost::str (boost::format ("Expired %1% send IDs") % expired);
+  }
   std::weak_ptr<chratos::node> node_w (shared_from_this ());
-  alarm.add (std::chrono::steady_clock::now () + (syn_cookie_cutoff * 2), [node_w]() {
+  alarm.add (std::chrono::steady_clock::now () + send_id_expiry_interval, [node_w]() {
     if (auto node_l = node_w.lock ())
     {
-      node_l->ongoing_syn_cookie_cleanup ();
+      node_l->ongoing_send_id_expiry ();
     }
   });
 }
 
-void chratos::node::ongoing_rep_crawl ()
+bool chratos::node::unchecked_clear_background ()
 {
-  auto now (std::chrono::steady_clock::now ());
-  auto peers_l (peers.rep_crawl ());
-  rep_query (*this, peers_l);
-  if (network.on)
+  auto result (unchecked_clearing.exchange (true));
+  if (!result)
   {
+    size_t remaining;
+    {
+      chratos::transaction transaction (store.environment, nullptr, false);
+      remaining = store.unchecked_count (transaction);
+    }
+    // Stops after as many entries as the table holds now so incoming blocks can't keep it running forever.
+    // Entries are removed in key order, so blocks arriving during the clear may be removed in place of older ones.
     std::weak_ptr<chratos::node> node_w (shared_from_this ());
-    alarm.add (now + std::chrono::seconds (4), [node_w]() {
+    background ([node_w, remaining]() {
       if (auto node_l = node_w.lock ())
       {
-        node_l->ongoing_rep_crawl ();
+        node_l->unchecked_clear_batch_run (remaining);
       }
     });
   }
+  return result;
 }
 
-void chratos::node::ongoing_bootstrap ()
+void chratos::node::unchecked_clear_batch_run (size_t remaining_a)
 {
-  auto next_wakeup (300);
-  if (warmed_up < 3)
+  size_t deleted;
   {
-    // Re-attempt bootstrapping more aggressively on startup
-    next_wakeup = 5;
-    if (!bootstrap_initiator.in_progress () && !peers.empty ())
-    {
-      ++warmed_up;
-    }
+    chratos::transaction transaction (store.environment, nullptr, true);
+    deleted = store.unchecked_clear (transaction, std::min (remaining_a, unchecked_clear_batch));
   }
-  bootstrap_initiator.bootstrap ();
-  std::weak_ptr<chratos::node> node_w (shared_from_this ());
-  alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (next_wakeup), [node_w]() {
-    if (auto node_l = node_w.lock ())
-    {
-      node_l->ongoing_bootstrap ();
-    }
-  });
-}
-
-void chratos::node::ongoing_store_flush ()
-{
+  auto remaining (remaining_a - deleted);
+  if (deleted == 0 || remaining == 0)
   {
-    chratos::transaction transaction (store.environment, nullptr, true);
-    store.flush (transaction);
+    BOOST_LOG (log) << "Finished clearing unchecked blocks";
+    unchecked_clearing = false;
   }
-  std::weak_ptr<chratos::node> node_w (shared_from_this ());
-  alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w]() {
-    if (auto node_l = node_w.lock ())
-    {
-      node_l->ongoing_store_flush ();
-    }
-  });
-}
-
-void chratos::node::backup_wallet ()
-{
-  chratos::transaction transaction (store.environment, nullptr, false);
-  for (auto i (wallets.items.begin ()), n (wallets.items.end ()); i != n; ++i)
+  else
   {
-    auto backup_path (application_path / "backup");
-    boost::filesystem::create_directories (backup_path);
-    i->second->store.write_backup (transaction, backup_path / (i->first.to_string () + ".json"));
+    std::weak_ptr<chratos::node> node_w (shared_from_this ());
+    alarm.add (std::chrono::steady_clock::now () + unchecked_clear_interval, [node_w, remaining]() {
+      if (auto node_l = node_w.lock ())
+      {
+        node_l->unchecked_clear_batch_run (remaining);
+      }
+    });
   }
-  auto this_l (shared ());
-  alarm.add (std::chrono::steady_clock::now () + backup_interval, [this_l]() {
-    this_l->backup_wallet ();
-  });
 }
 
 int chratos::node::price (chratos::uint128_t const & balance_a, int amount_a)
@@ -2819,8 +3640,24 @@ void chratos::node::add_initial_peers ()
 
 void chratos::node::block_confirm (std::shared_ptr<chratos::block> block_a)
 {
-  active.start (block_a);
-  network.broadcast_confirm_req (block_a);
+  auto confirmed (false);
+  {
+    chratos::transaction transaction (store.environment, nullptr, false);
+    confirmed = ledger.block_confirmed (transaction, block_a->hash ()) == chratos::confirmation_status::confirmed;
+  }
+  if (confirmed)
+  {
+    // Already cemented, skip the vote round and go straight to the confirmation observers
+    auto node_l (shared ());
+    background ([node_l, block_a]() {
+      node_l->process_confirmed (block_a);
+    });
+  }
+  else
+  {
+    active.start (block_a);
+    network.broadcast_confirm_req (block_a);
+  }
 }
 
 chratos::uint128_t chratos::node::delta ()
@@ -2877,39 +3714,22 @@ public:
   }
   void claim_dividend (chratos::dividend_block const & block_a)
   {
-    std::shared_ptr<chratos::block> dividend_l = node.store.block_get (transaction, block_a.hash ());
+    auto dividend_hash (block_a.hash ());
     for (auto i (node.wallets.items.begin ()), n (node.wallets.items.end ()); i != n; ++i)
     {
       auto wallet (i->second);
-      auto accounts = wallet->search_unclaimed (block_a.hash ());
-      chratos::account representative;
-      representative = wallet->store.representative (transaction);
-
-      for (auto & account : accounts)
+      auto accounts (wallet->search_unclaimed (dividend_hash));
+      if (!accounts.empty ())
       {
-        // Check pending and claim outstanding
-        receive_outstanding_pendings (wallet, account, block_a.hash ());
-        // Check dividend points to the account's last claimed
-        chratos::account_info info;
-        node.store.account_get (transaction, account, info);
-        if (info.dividend_block == dividend_l->dividend ()) {
-          // Claim dividends
-          wallet->claim_dividend_async (dividend_l, account, representative, [](std::shared_ptr<chratos::block>) {});
-        } else {
-          auto prev_hash = dividend_l->dividend ();
-          std::shared_ptr<chratos::block> previous = node.store.block_get (transaction, prev_hash);
-          chratos::dividend_block const * prev_dividend (dynamic_cast<chratos::dividend_block const *> (previous.get ()));
-          claim_dividend (*prev_dividend);
-          claim_dividend (block_a);
+        auto representative (wallet->store.representative (transaction));
+        for (auto & account : accounts)
+        {
+          // Receives and claims any older dividends ahead of this one from fresh ledger state on the action thread
+          wallet->claim_chain_async (account, representative, dividend_hash, [](std::vector<std::shared_ptr<chratos::block>>) {});
         }
       }
     }
   }
-
-  void receive_outstanding_pendings (std::shared_ptr<chratos::wallet> wallet, chratos::account const & account_a, chratos::block_hash const & dividend_a)
-  {
-    wallet->receive_outstanding_pendings_sync (transaction, account_a, dividend_a);
-  }
   void state_block (chratos::state_block const & block_a) override
   {
     scan_receivable (block_a.hashables.link);
@@ -2942,6 +3762,8 @@ void chratos::node::process_confirmed (std::shared_ptr<chratos::block> block_a)
   }
   if (exists)
   {
+    confirmation_heights.add (hash);
+    rep_crawler.observe (block_a);
     auto dividend (block_a->dividend ());
     chratos::transaction transaction (store.environment, nullptr, false);
     confirmed_visitor visitor (transaction, *this, block_a, hash, dividend);
@@ -2993,6 +3815,75 @@ bool chratos::block_arrival::add (chratos::block_hash const & hash_a)
   return result;
 }
 
+chratos::vote_reuse::vote_reuse (std::chrono::milliseconds window_a) :
+window (window_a)
+{
+}
+
+bool chratos::vote_reuse::find (chratos::account const & representative_a, chratos::block_hash const & hash_a, std::shared_ptr<chratos::vote> & vote_a, std::shared_ptr<std::vector<uint8_t>> & bytes_a)
+{
+  auto result (true);
+  if (window.count () != 0)
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    purge (std::chrono::steady_clock::now ());
+    auto existing (votes.get<1> ().equal_range (hash_a));
+    for (auto i (existing.first); i != existing.second && result; ++i)
+    {
+      if (i->representative == representative_a)
+      {
+        vote_a = i->vote;
+        bytes_a = i->bytes;
+        result = false;
+      }
+    }
+  }
+  return result;
+}
+
+void chratos::vote_reuse::insert (std::shared_ptr<chratos::vote> vote_a, std::shared_ptr<std::vector<uint8_t>> bytes_a)
+{
+  if (window.count () != 0 && vote_a->blocks.size () == 1)
+  {
+    auto now (std::chrono::steady_clock::now ());
+    std::lock_guard<std::mutex> lock (mutex);
+    purge (now);
+    auto hash (*vote_a->begin ());
+    // A newer vote replaces the one this representative had for the block
+    auto existing (votes.get<1> ().equal_range (hash));
+    for (auto i (existing.first); i != existing.second;)
+    {
+      if (i->representative == vote_a->account)
+      {
+        i = votes.get<1> ().erase (i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+    votes.insert (chratos::vote_reuse_info{ now, vote_a->account, hash, vote_a, bytes_a });
+    while (votes.size () > votes_max)
+    {
+      votes.erase (votes.begin ());
+    }
+  }
+}
+
+size_t chratos::vote_reuse::size ()
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return votes.size ();
+}
+
+void chratos::vote_reuse::purge (std::chrono::steady_clock::time_point const & now_a)
+{
+  while (!votes.empty () && votes.begin ()->created + window < now_a)
+  {
+    votes.erase (votes.begin ());
+  }
+}
+
 bool chratos::block_arrival::recent (chratos::block_hash const & hash_a)
 {
   std::lock_guard<std::mutex> lock (mutex);
@@ -3004,6 +3895,53 @@ bool chratos::block_arrival::recent (chratos::block_hash const & hash_a)
   return arrival.get<1> ().find (hash_a) != arrival.get<1> ().end ();
 }
 
+chratos::startup_profile::startup_profile (boost::log::sources::logger_mt & log_a) :
+begin (std::chrono::steady_clock::now ()),
+last (begin),
+finished (begin),
+log (log_a)
+{
+}
+
+void chratos::startup_profile::phase (std::string const & name_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  auto now (std::chrono::steady_clock::now ());
+  add (name_a, now - last, false);
+  last = now;
+}
+
+void chratos::startup_profile::record (std::string const & name_a, std::chrono::steady_clock::time_point const & begin_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  add (name_a, std::chrono::steady_clock::now () - begin_a, true);
+}
+
+void chratos::startup_profile::add (std::string const & name_a, std::chrono::steady_clock::duration const & duration_a, bool concurrent_a)
+{
+  auto duration (std::chrono::duration_cast<std::chrono::milliseconds> (duration_a));
+  phases.push_back ({ name_a, duration, concurrent_a });
+  finished = std::max (finished, std::chrono::steady_clock::now ());
+  BOOST_LOG (log) << boost::str (boost::format ("Startup phase %1% took %2% ms%3%") % name_a % duration.count () % (concurrent_a ? " (concurrent)" : ""));
+}
+
+void chratos::startup_profile::serialize (boost::property_tree::ptree & tree_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  boost::property_tree::ptree phases_l;
+  for (auto & phase : phases)
+  {
+    boost::property_tree::ptree entry;
+    entry.put ("phase", phase.name);
+    entry.put ("milliseconds", std::to_string (phase.duration.count ()));
+    entry.put ("concurrent", phase.concurrent ? "true" : "false");
+    phases_l.push_back (std::make_pair ("", entry));
+  }
+  tree_a.add_child ("phases", phases_l);
+  // Time from construction until the last phase finished, sequential or not
+  tree_a.put ("ready_milliseconds", std::to_string (std::chrono::duration_cast<std::chrono::milliseconds> (finished - begin).count ()));
+}
+
 chratos::online_reps::online_reps (chratos::node & node) :
 node (node)
 {
@@ -3142,28 +4080,9 @@ std::vector<chratos::peer_information> chratos::peer_container::representatives
 
 void chratos::peer_container::purge_syn_cookies (std::chrono::steady_clock::time_point const & cutoff)
 {
-  std::lock_guard<std::mutex> lock (syn_cookie_mutex);
-  auto it (syn_cookies.begin ());
-  while (it != syn_cookies.end ())
+  for (auto & shard : syn_cookie_shards)
   {
-    auto info (it->second);
-    if (info.created_at < cutoff)
-    {
-      unsigned & per_ip = syn_cookies_per_ip[it->first.address ()];
-      if (per_ip > 0)
-      {
-        --per_ip;
-      }
-      else
-      {
-        assert (false && "More SYN cookies deleted than created for IP");
-      }
-      it = syn_cookies.erase (it);
-    }
-    else
-    {
-      ++it;
-    }
+    shard.purge (cutoff);
   }
 }
 
@@ -3188,6 +4107,10 @@ std::vector<chratos::peer_information> chratos::peer_container::purge_list (std:
         }
       }
     }
+    for (auto i (peers.get<1> ().begin ()); i != pivot; ++i)
+    {
+      rep_weight_erase (i->probable_rep_account, i->rep_weight.number ());
+    }
     // Remove peers that haven't been heard from past the cutoff
     peers.get<1> ().erase (peers.get<1> ().begin (), pivot);
     for (auto i (peers.begin ()), n (peers.end ()); i != n; ++i)
@@ -3198,6 +4121,19 @@ std::vector<chratos::peer_information> chratos::peer_container::purge_list (std:
     // Remove keepalive attempt tracking for attempts older than cutoff
     auto attempts_pivot (attempts.get<1> ().lower_bound (cutoff));
     attempts.get<1> ().erase (attempts.get<1> ().begin (), attempts_pivot);
+
+    // Forget restored peers which never completed a handshake
+    for (auto i (restored.begin ()); i != restored.end ();)
+    {
+      if (i->second.last_contact < cutoff)
+      {
+        i = restored.erase (i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
   }
   if (result.empty ())
   {
@@ -3234,6 +4170,12 @@ size_t chratos::peer_container::size_sqrt ()
 }
 
 chratos::uint128_t chratos::peer_container::total_weight ()
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return rep_weights_total;
+}
+
+bool chratos::peer_container::verify_total_weight ()
 {
   chratos::uint128_t result (0);
   std::unordered_set<chratos::account> probable_reps;
@@ -3247,7 +4189,54 @@ chratos::uint128_t chratos::peer_container::total_weight ()
       probable_reps.insert (i->probable_rep_account);
     }
   }
-  return result;
+  auto drifted (result != rep_weights_total);
+  if (drifted)
+  {
+    rep_weights.clear ();
+    rep_weights_total = 0;
+    for (auto i (peers.begin ()), n (peers.end ()); i != n; ++i)
+    {
+      rep_weight_insert (i->probable_rep_account, i->rep_weight.number ());
+    }
+    assert (rep_weights_total == result);
+  }
+  return drifted;
+}
+
+void chratos::peer_container::rep_weight_insert (chratos::account const & account_a, chratos::uint128_t const & weight_a)
+{
+  if (weight_a != 0)
+  {
+    auto & weights (rep_weights[account_a]);
+    chratos::uint128_t previous (weights.empty () ? 0 : *weights.rbegin ());
+    weights.insert (weight_a);
+    rep_weights_total = rep_weights_total - previous + *weights.rbegin ();
+  }
+}
+
+void chratos::peer_container::rep_weight_erase (chratos::account const & account_a, chratos::uint128_t const & weight_a)
+{
+  if (weight_a != 0)
+  {
+    auto existing (rep_weights.find (account_a));
+    assert (existing != rep_weights.end ());
+    if (existing != rep_weights.end ())
+    {
+      auto & weights (existing->second);
+      auto previous (*weights.rbegin ());
+      auto weight (weights.find (weight_a));
+      assert (weight != weights.end ());
+      if (weight != weights.end ())
+      {
+        weights.erase (weight);
+      }
+      rep_weights_total = rep_weights_total - previous + (weights.empty () ? 0 : *weights.rbegin ());
+      if (weights.empty ())
+      {
+        rep_weights.erase (existing);
+      }
+    }
+  }
 }
 
 bool chratos::peer_container::empty ()
@@ -3281,6 +4270,8 @@ bool chratos::peer_container::rep_response (chratos::endpoint const & endpoint_a
   auto existing (peers.find (endpoint_a));
   if (existing != peers.end ())
   {
+    auto previous_account (existing->probable_rep_account);
+    auto previous_weight (existing->rep_weight);
     peers.modify (existing, [weight_a, &updated, rep_account_a](chratos::peer_information & info) {
       info.last_rep_response = std::chrono::steady_clock::now ();
       if (info.rep_weight < weight_a)
@@ -3290,6 +4281,11 @@ bool chratos::peer_container::rep_response (chratos::endpoint const & endpoint_a
         info.probable_rep_account = rep_account_a;
       }
     });
+    if (updated)
+    {
+      rep_weight_erase (previous_account, previous_weight.number ());
+      rep_weight_insert (rep_account_a, weight_a.number ());
+    }
   }
   return updated;
 }
@@ -3323,7 +4319,29 @@ bool chratos::peer_container::reachout (chratos::endpoint const & endpoint_a)
   return error;
 }
 
-bool chratos::peer_container::insert (chratos::endpoint const & endpoint_a, unsigned version_a)
+std::vector<chratos::endpoint> chratos::peer_container::reachout_many (std::vector<chratos::endpoint> const & endpoints_a)
+{
+  std::vector<chratos::endpoint> result;
+  auto now (std::chrono::steady_clock::now ());
+  std::lock_guard<std::mutex> lock (mutex);
+  for (auto & endpoint : endpoints_a)
+  {
+    // Don't contact invalid IPs
+    if (!not_a_peer (endpoint, false))
+    {
+      auto endpoint_l (chratos::map_endpoint_to_v6 (endpoint));
+      // Don't keepalive to nodes that already sent us something or that we've recently tried
+      if (peers.find (endpoint_l) == peers.end () && attempts.find (endpoint_l) == attempts.end ())
+      {
+        attempts.insert ({ endpoint_l, now });
+        result.push_back (endpoint_l);
+      }
+    }
+  }
+  return result;
+}
+
+bool chratos::peer_container::insert (chratos::endpoint const & endpoint_a, unsigned version_a, boost::optional<chratos::account> const & node_id_a)
 {
   assert (endpoint_a.address ().is_v6 ());
   auto unknown (false);
@@ -3337,8 +4355,12 @@ bool chratos::peer_container::insert (chratos::endpoint const & endpoint_a, unsi
       auto existing (peers.find (endpoint_a));
       if (existing != peers.end ())
       {
-        peers.modify (existing, [](chratos::peer_information & info) {
+        peers.modify (existing, [&node_id_a](chratos::peer_information & info) {
           info.last_contact = std::chrono::steady_clock::now ();
+          if (node_id_a)
+          {
+            info.node_id = node_id_a;
+          }
           // Don't update `network_version` here unless you handle the legacy peer caps (both global and per IP)
           // You'd need to ensure that an upgrade from network version 7 to 8 entails a node ID handshake
         });
@@ -3381,7 +4403,21 @@ bool chratos::peer_container::insert (chratos::endpoint const & endpoint_a, unsi
         }
         if (!result)
         {
-          peers.insert (chratos::peer_information (endpoint_a, version_a));
+          chratos::peer_information info (endpoint_a, version_a);
+          info.node_id = node_id_a;
+          auto restored_l (restored.find (endpoint_a));
+          if (restored_l != restored.end ())
+          {
+            // Only trust the weight observed before a restart if the peer proved it's still the same node
+            if (node_id_a && restored_l->second.node_id == node_id_a)
+            {
+              info.rep_weight = restored_l->second.rep_weight;
+              info.probable_rep_account = restored_l->second.probable_rep_account;
+              rep_weight_insert (info.probable_rep_account, info.rep_weight.number ());
+            }
+            restored.erase (restored_l);
+          }
+          peers.insert (info);
         }
       }
     }
@@ -3538,10 +4574,21 @@ chratos::peer_container::peer_container (chratos::endpoint const & self_a) :
 self (self_a),
 peer_observer ([](chratos::endpoint const &) {}),
 disconnect_observer ([]() {}),
-legacy_peers (0)
+legacy_peers (0),
+rep_weights_total (0)
 {
 }
 
+void chratos::peer_container::restore (std::vector<chratos::peer_information> const & peers_a)
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  for (auto & info : peers_a)
+  {
+    restored.erase (info.endpoint);
+    restored.emplace (info.endpoint, info);
+  }
+}
+
 bool chratos::peer_container::contacted (chratos::endpoint const & endpoint_a, unsigned version_a)
 {
   auto endpoint_l (chratos::map_endpoint_to_v6 (endpoint_a));
@@ -3614,7 +4661,7 @@ void chratos::election::compute_rep_votes (MDB_txn * transaction_a)
 {
   if (node.config.enable_voting)
   {
-    node.wallets.foreach_representative (transaction_a, [this, transaction_a](chratos::public_key const & pub_a, chratos::raw_key const & prv_a) {
+    node.wallets.foreach_representative (transaction_a, [this, transaction_a](chratos::public_key const & pub_a, chratos::expanded_key const & prv_a) {
       auto vote (this->node.store.vote_generate (transaction_a, pub_a, prv_a, status.winner));
       this->node.vote_processor.vote (vote, this->node.network.endpoint ());
     });
@@ -3833,7 +4880,7 @@ void chratos::active_transactions::announce_votes ()
             blocks_bundle.push_back (election_l->status.winner->hash ());
             if (blocks_bundle.size () >= 12)
             {
-              node.wallets.foreach_representative (transaction, [&](chratos::public_key const & pub_a, chratos::raw_key const & prv_a) {
+              node.wallets.foreach_representative (transaction, [&](chratos::public_key const & pub_a, chratos::expanded_key const & prv_a) {
                 auto vote (this->node.store.vote_generate (transaction, pub_a, prv_a, blocks_bundle));
                 this->node.vote_processor.vote (vote, this->node.network.endpoint ());
               });
@@ -3854,18 +4901,11 @@ void chratos::active_transactions::announce_votes ()
       if (i->announcements % 4 == 1)
       {
         auto reps (std::make_shared<std::vector<chratos::peer_information>> (node.peers.representatives (std::numeric_limits<size_t>::max ())));
-        std::unordered_set<chratos::account> probable_reps;
-        chratos::uint128_t total_weight (0);
+        auto total_weight (node.peers.total_weight ());
         for (auto j (reps->begin ()), m (reps->end ()); j != m;)
         {
           auto & rep_votes (i->election->last_votes);
           auto rep_acct (j->probable_rep_account);
-          // Calculate if representative isn't recorded for several IP addresses
-          if (probable_reps.find (rep_acct) == probable_reps.end ())
-          {
-            total_weight = total_weight + j->rep_weight.number ();
-            probable_reps.insert (rep_acct);
-          }
           if (rep_votes.find (rep_acct) != rep_votes.end ())
           {
             std::swap (*j, reps->back ());
@@ -3900,7 +4940,7 @@ void chratos::active_transactions::announce_votes ()
   }
   if (node.config.enable_voting && !blocks_bundle.empty ())
   {
-    node.wallets.foreach_representative (transaction, [&](chratos::public_key const & pub_a, chratos::raw_key const & prv_a) {
+    node.wallets.foreach_representative (transaction, [&](chratos::public_key const & pub_a, chratos::expanded_key const & prv_a) {
       auto vote (this->node.store.vote_generate (transaction, pub_a, prv_a, blocks_bundle));
       this->node.vote_processor.vote (vote, this->node.network.endpoint ());
     });
@@ -10,6 +10,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <thread>
 #include <unordered_set>
 
@@ -218,6 +219,28 @@ public:
 	chratos::uint256_union cookie;
 	std::chrono::steady_clock::time_point created_at;
 };
+// Syn cookies for the subset of IP addresses which hash to this shard
+// Cookies are also filed in a bucket per creation interval so expiry drops whole buckets instead of scanning every cookie
+class syn_cookie_shard
+{
+public:
+	// Returns boost::none if the IP has max_per_ip cookies outstanding or the endpoint already has one
+	boost::optional<chratos::uint256_union> assign (chratos::endpoint const &, size_t);
+	boost::optional<chratos::uint256_union> cookie (chratos::endpoint const &);
+	// Removes the endpoint's cookie if it is still the given one, returns true if it wasn't found
+	bool erase (chratos::endpoint const &, chratos::uint256_union const &);
+	void purge (std::chrono::steady_clock::time_point const &);
+	size_t size ();
+	static std::chrono::seconds constexpr bucket_interval = std::chrono::seconds (1);
+
+private:
+	void erase_locked (std::unordered_map<chratos::endpoint, syn_cookie_info>::iterator);
+	std::mutex mutex;
+	std::unordered_map<chratos::endpoint, syn_cookie_info> cookies;
+	std::unordered_map<boost::asio::ip::address, unsigned> cookies_per_ip;
+	// Start of each bucket's interval and the endpoints assigned a cookie during it, oldest first
+	std::deque<std::pair<std::chrono::steady_clock::time_point, std::vector<chratos::endpoint>>> buckets;
+};
 class peer_by_ip_addr
 {
 };
@@ -232,8 +255,10 @@ public:
 	bool not_a_peer (chratos::endpoint const &, bool);
 	// Returns true if peer was already known
 	bool known_peer (chratos::endpoint const &);
-	// Notify of peer we received from
-	bool insert (chratos::endpoint const &, unsigned);
+	// Notify of peer we received from, optionally with the node ID it proved ownership of
+	bool insert (chratos::endpoint const &, unsigned, boost::optional<chratos::account> const & = boost::none);
+	// Peers read back from a snapshot, their observed weight is reinstated when they handshake with the same node ID
+	void restore (std::vector<chratos::peer_information> const &);
 	std::unordered_set<chratos::endpoint> random_set (size_t);
 	void random_fill (std::array<chratos::endpoint, 8> &);
 	// Request a list of the top known representatives
@@ -254,15 +279,25 @@ public:
 	void rep_request (chratos::endpoint const &);
 	// Should we reach out to this endpoint with a keepalive message
 	bool reachout (chratos::endpoint const &);
+	// Filter a batch of endpoints down to those we should reach out to, in one pass under the lock
+	std::vector<chratos::endpoint> reachout_many (std::vector<chratos::endpoint> const &);
 	// Returns boost::none if the IP is rate capped on syn cookie requests,
 	// or if the endpoint already has a syn cookie query
 	boost::optional<chratos::uint256_union> assign_syn_cookie (chratos::endpoint const &);
 	// Returns false if valid, true if invalid (true on error convention)
 	// Also removes the syn cookie from the store if valid
 	bool validate_syn_cookie (chratos::endpoint const &, chratos::account, chratos::signature);
+	// Outstanding syn cookie for the endpoint, if any
+	boost::optional<chratos::uint256_union> syn_cookie (chratos::endpoint const &);
+	// Removes the syn cookie after its response was validated elsewhere, returns true if it was no longer outstanding
+	bool erase_syn_cookie (chratos::endpoint const &, chratos::uint256_union const &);
+	chratos::syn_cookie_shard & syn_cookie_shard_for (boost::asio::ip::address const &);
 	size_t size ();
 	size_t size_sqrt ();
+	// Sum of observed weight counting each probable representative once
 	chratos::uint128_t total_weight ();
+	// Recompute total_weight by scanning every peer, returns true if the maintained sum had drifted
+	bool verify_total_weight ();
 	chratos::uint128_t online_weight_minimum;
 	bool empty ();
 	std::mutex mutex;
@@ -285,11 +320,18 @@ public:
 	boost::multi_index::hashed_unique<boost::multi_index::member<peer_attempt, chratos::endpoint, &peer_attempt::endpoint>>,
 	boost::multi_index::ordered_non_unique<boost::multi_index::member<peer_attempt, std::chrono::steady_clock::time_point, &peer_attempt::last_attempt>>>>
 	attempts;
-	std::mutex syn_cookie_mutex;
-	std::unordered_map<chratos::endpoint, syn_cookie_info> syn_cookies;
-	std::unordered_map<boost::asio::ip::address, unsigned> syn_cookies_per_ip;
+	static size_t constexpr syn_cookie_shards_count = 16;
+	std::array<chratos::syn_cookie_shard, syn_cookie_shards_count> syn_cookie_shards;
 	// Number of peers that don't support node ID
 	size_t legacy_peers;
+	// Weights reported by peers for each probable representative, the highest of each is counted in rep_weights_total
+	// Both are guarded by mutex and updated whenever a peer's rep_weight changes or the peer is removed
+	std::unordered_map<chratos::account, std::multiset<chratos::uint128_t>> rep_weights;
+	// Restored peers which haven't completed a handshake yet, dropped by purge_list once their last_contact passes the cutoff
+	std::unordered_map<chratos::endpoint, chratos::peer_information> restored;
+	chratos::uint128_t rep_weights_total;
+	void rep_weight_insert (chratos::account const &, chratos::uint128_t const &);
+	void rep_weight_erase (chratos::account const &, chratos::uint128_t const &);
 	// Called when a new peer is observed
 	std::function<void(chratos::endpoint const &)> peer_observer;
 	std::function<void()> disconnect_observer;
@@ -369,12 +411,71 @@ public:
 	static size_t constexpr arrival_size_min = 8 * 1024;
 	static std::chrono::seconds constexpr arrival_time_min = std::chrono::seconds (300);
 };
+class vote_reuse_info
+{
+public:
+	std::chrono::steady_clock::time_point created;
+	chratos::account representative;
+	chratos::block_hash hash;
+	std::shared_ptr<chratos::vote> vote;
+	std::shared_ptr<std::vector<uint8_t>> bytes;
+};
+// Recently signed confirm_acks for single blocks, repeated confirm_reqs for a block inside the window are answered with the same vote
+class vote_reuse
+{
+public:
+	vote_reuse (std::chrono::milliseconds);
+	// The representative's current vote on hash_a and its serialized confirm_ack, returns true if there isn't one
+	bool find (chratos::account const &, chratos::block_hash const &, std::shared_ptr<chratos::vote> &, std::shared_ptr<std::vector<uint8_t>> &);
+	void insert (std::shared_ptr<chratos::vote>, std::shared_ptr<std::vector<uint8_t>>);
+	size_t size ();
+	boost::multi_index_container<
+	chratos::vote_reuse_info,
+	boost::multi_index::indexed_by<
+	boost::multi_index::ordered_non_unique<boost::multi_index::member<chratos::vote_reuse_info, std::chrono::steady_clock::time_point, &chratos::vote_reuse_info::created>>,
+	boost::multi_index::hashed_non_unique<boost::multi_index::member<chratos::vote_reuse_info, chratos::block_hash, &chratos::vote_reuse_info::hash>>>>
+	votes;
+	std::chrono::milliseconds window;
+	std::mutex mutex;
+	static size_t constexpr votes_max = 16 * 1024;
+
+private:
+	void purge (std::chrono::steady_clock::time_point const &);
+};
 class rep_last_heard_info
 {
 public:
 	std::chrono::steady_clock::time_point last_heard;
 	chratos::account representative;
 };
+class startup_phase
+{
+public:
+	std::string name;
+	std::chrono::milliseconds duration;
+	// Ran alongside the sequential phases rather than after the previous one
+	bool concurrent;
+};
+/** Wall time of each node startup phase, logged as each one completes and reported through the startup_profile RPC */
+class startup_profile
+{
+public:
+	startup_profile (boost::log::sources::logger_mt &);
+	// Close the sequential phase that has been running since the previous call
+	void phase (std::string const &);
+	// Close a phase that started at the given time and ran concurrently with the others
+	void record (std::string const &, std::chrono::steady_clock::time_point const &);
+	void serialize (boost::property_tree::ptree &);
+	std::chrono::steady_clock::time_point const begin;
+
+private:
+	void add (std::string const &, std::chrono::steady_clock::duration const &, bool);
+	std::mutex mutex;
+	std::chrono::steady_clock::time_point last;
+	std::chrono::steady_clock::time_point finished;
+	std::vector<chratos::startup_phase> phases;
+	boost::log::sources::logger_mt & log;
+};
 class online_reps
 {
 public:
@@ -408,8 +509,12 @@ public:
 	void republish (chratos::block_hash const &, std::shared_ptr<std::vector<uint8_t>>, chratos::endpoint);
 	void publish_broadcast (std::vector<chratos::peer_information> &, std::unique_ptr<chratos::block>);
 	void confirm_send (chratos::confirm_ack const &, std::shared_ptr<std::vector<uint8_t>>, chratos::endpoint const &);
+	// Queue the endpoints from a keepalive, they're contacted with the next batch
 	void merge_peers (std::array<chratos::endpoint, 8> const &);
+	void merge_peers_flush ();
 	void send_keepalive (chratos::endpoint const &);
+	// Send the same keepalive contents to every endpoint
+	void send_keepalives (std::vector<chratos::endpoint> const &);
 	void send_node_id_handshake (chratos::endpoint const &, boost::optional<chratos::uint256_union> const & query, boost::optional<chratos::uint256_union> const & respond_to);
 	void broadcast_confirm_req (std::shared_ptr<chratos::block>);
 	void broadcast_confirm_req_base (std::shared_ptr<chratos::block>, std::shared_ptr<std::vector<chratos::peer_information>>, unsigned);
@@ -423,7 +528,14 @@ public:
 	boost::asio::ip::udp::resolver resolver;
 	chratos::node & node;
 	bool on;
+	std::mutex merge_mutex;
+	std::unordered_set<chratos::endpoint> merge_candidates;
+	bool merge_scheduled;
 	static uint16_t const node_port = chratos::chratos_network == chratos::chratos_networks::chratos_live_network ? 9125 : 44000;
+	// Keepalive peers are collected for this long before being contacted together
+	static unsigned constexpr merge_peers_interval_ms = (chratos::chratos_network == chratos::chratos_networks::chratos_test_network) ? 10 : 500;
+	// Maximum number of candidates held and keepalives sent per batch
+	static size_t constexpr merge_peers_max = 256;
 };
 class logging
 {
@@ -511,6 +623,13 @@ public:
 	chratos::uint256_union epoch_block_link;
 	chratos::account epoch_block_signer;
 	std::chrono::system_clock::time_point generate_hash_votes_at;
+	bool rep_crawl_recent_confirmed;
+	// Seconds between full recomputations of the cached peer weight, 0 disables verification
+	unsigned peer_weight_verification_interval;
+	// Hours a send ID is remembered for idempotent sends, 0 keeps them forever
+	unsigned send_id_retention;
+	// Milliseconds a signed vote for a block is re-sent instead of signing a new one, 0 signs every time
+	unsigned vote_reuse_window;
 	static std::chrono::seconds constexpr keepalive_period = std::chrono::seconds (60);
 	static std::chrono::seconds constexpr keepalive_cutoff = keepalive_period * 5;
 	static std::chrono::minutes constexpr wallet_backup_interval = std::chrono::minutes (5);
@@ -546,15 +665,79 @@ private:
 	bool active;
 	std::thread thread;
 };
+// Node ID handshake responses are queued and their signatures verified in batches instead of one at a time on the network threads
+class handshake_verifier
+{
+public:
+	handshake_verifier (chratos::node &);
+	void add (chratos::endpoint const &, chratos::account const &, chratos::signature const &, unsigned);
+	void stop ();
+	chratos::node & node;
+	static size_t constexpr max_batch = 64;
+	static size_t constexpr max_queued = 4096;
+
+private:
+	class response
+	{
+	public:
+		chratos::endpoint endpoint;
+		chratos::account node_id;
+		chratos::signature signature;
+		unsigned version;
+	};
+	void process_loop ();
+	void verify_batch (std::deque<response> const &);
+	std::deque<response> responses;
+	std::condition_variable condition;
+	std::mutex mutex;
+	bool started;
+	bool stopped;
+	std::thread thread;
+};
+// Confirmed blocks are cemented on their own thread in short write transactions so a long unconfirmed chain doesn't hold up the writer
+class confirmation_height_processor
+{
+public:
+	confirmation_height_processor (chratos::node &);
+	void add (chratos::block_hash const &);
+	void flush ();
+	void stop ();
+	chratos::node & node;
+	// Blocks scanned or cemented per write transaction
+	static size_t constexpr batch_max = 4096;
+	static size_t constexpr max_queued = 16384;
+
+private:
+	void process_loop ();
+	void cement (chratos::block_hash const &);
+	std::deque<chratos::block_hash> hashes;
+	std::condition_variable condition;
+	std::mutex mutex;
+	bool started;
+	bool stopped;
+	bool active;
+	std::thread thread;
+};
 // The network is crawled for representatives by occasionally sending a unicast confirm_req for a specific block and watching to see if it's acknowledged with a vote.
+// Probes use recently confirmed blocks when available since they're still cached on both ends, otherwise a random block from the ledger.
 class rep_crawler
 {
 public:
 	void add (chratos::block_hash const &);
 	void remove (chratos::block_hash const &);
 	bool exists (chratos::block_hash const &);
+	// Remember a block confirmed by an election as a probe candidate
+	void observe (std::shared_ptr<chratos::block>);
+	// Random recently confirmed block or nullptr if none have been observed
+	std::shared_ptr<chratos::block> recent_block ();
+	// Queue an endpoint to be probed with the next crawl batch
+	void queue (chratos::endpoint const &);
+	std::vector<chratos::endpoint> take_queued ();
 	std::mutex mutex;
-	std::unordered_set<chratos::block_hash> active;
+	std::unordered_multiset<chratos::block_hash> active;
+	std::deque<std::shared_ptr<chratos::block>> recent;
+	std::unordered_set<chratos::endpoint> queued;
+	static size_t constexpr recent_size = 64;
 };
 // Processing blocks is a potentially long IO operation
 // This class isolates block insertion from other operations like servicing network operations
@@ -567,6 +750,8 @@ public:
 	void flush ();
 	bool full ();
 	void add (std::shared_ptr<chratos::block>, std::chrono::steady_clock::time_point);
+	// Queue a locally submitted block ahead of network blocks and call the completion with its own result once the transaction holding it has committed
+	void add (std::shared_ptr<chratos::block>, std::chrono::steady_clock::time_point, std::function<void(chratos::process_return const &)>);
 	void force (std::shared_ptr<chratos::block>);
 	bool should_log ();
 	bool have_blocks ();
@@ -576,12 +761,15 @@ public:
 private:
 	void queue_unchecked (MDB_txn *, chratos::block_hash const &);
 	void process_receive_many (std::unique_lock<std::mutex> &);
+	void complete (std::vector<std::pair<chratos::block_hash, chratos::process_return>> const &);
 	bool stopped;
 	bool active;
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<std::pair<std::shared_ptr<chratos::block>, std::chrono::steady_clock::time_point>> blocks;
 	std::unordered_set<chratos::block_hash> blocks_hashes;
+	std::deque<std::pair<std::shared_ptr<chratos::block>, std::chrono::steady_clock::time_point>> local;
 	std::deque<std::shared_ptr<chratos::block>> forced;
+	std::unordered_multimap<chratos::block_hash, std::function<void(chratos::process_return const &)>> completions;
 	std::condition_variable condition;
 	chratos::node & node;
 	std::mutex mutex;
@@ -607,6 +795,10 @@ public:
 	void process_confirmed (std::shared_ptr<chratos::block>);
 	void process_message (chratos::message &, chratos::endpoint const &);
 	void process_active (std::shared_ptr<chratos::block>);
+	// Queue a locally created block and wait for its own result rather than for the whole queue to drain, returns true if the node stopped first
+	bool process_local (std::shared_ptr<chratos::block>, chratos::process_return &);
+	// Queue a chain of locally created blocks in order and wait for each of their results
+	bool process_local (std::vector<std::shared_ptr<chratos::block>> const &, std::vector<chratos::process_return> &);
 	chratos::process_return process (chratos::block const &);
 	void keepalive_preconfigured (std::vector<std::string> const &);
 	chratos::block_hash latest (chratos::account const &);
@@ -618,9 +810,18 @@ public:
 	void ongoing_keepalive ();
 	void ongoing_syn_cookie_cleanup ();
 	void ongoing_rep_crawl ();
+	void ongoing_peer_weight_verification ();
 	void ongoing_bootstrap ();
 	void ongoing_store_flush ();
 	void backup_wallet ();
+	// Write the peer table to peers.json so a restart can reach the same peers straight away
+	void save_peers ();
+	// Reach out to the peers from a recent enough snapshot
+	void restore_peers ();
+	void ongoing_peer_snapshot ();
+	void ongoing_send_id_expiry ();
+	// Empty the unchecked table in short write transactions so block processing isn't stalled, returns true if a clear is already running
+	bool unchecked_clear_background ();
 	int price (chratos::uint128_t const &, int);
 	void work_generate_blocking (chratos::block &);
 	uint64_t work_generate_blocking (chratos::uint256_union const &);
@@ -635,6 +836,7 @@ public:
 	chratos::alarm & alarm;
 	chratos::work_pool & work;
 	boost::log::sources::logger_mt log;
+	chratos::startup_profile startup;
 	chratos::block_store store;
 	chratos::gap_cache gap_cache;
 	chratos::ledger ledger;
@@ -648,20 +850,34 @@ public:
 	chratos::wallets wallets;
 	chratos::port_mapping port_mapping;
 	chratos::vote_processor vote_processor;
+	chratos::handshake_verifier handshake_verifier;
 	chratos::rep_crawler rep_crawler;
+	chratos::confirmation_height_processor confirmation_heights;
 	unsigned warmed_up;
 	chratos::block_processor block_processor;
 	std::thread block_processor_thread;
 	chratos::block_arrival block_arrival;
+	chratos::vote_reuse vote_reuse;
 	chratos::online_reps online_reps;
 	chratos::stat stats;
 	chratos::keypair node_id;
+	std::atomic<bool> unchecked_clearing;
+	// Between start and the first stop
+	std::atomic<bool> started;
 	static double constexpr price_max = 16.0;
 	static double constexpr free_cutoff = 1024.0;
 	static std::chrono::seconds constexpr period = std::chrono::seconds (60);
 	static std::chrono::seconds constexpr cutoff = period * 5;
 	static std::chrono::seconds constexpr syn_cookie_cutoff = std::chrono::seconds (5);
 	static std::chrono::minutes constexpr backup_interval = std::chrono::minutes (5);
+	static std::chrono::minutes constexpr peer_snapshot_interval = std::chrono::minutes (5);
+	static std::chrono::hours constexpr peer_snapshot_cutoff = std::chrono::hours (1);
+	static std::chrono::minutes constexpr send_id_expiry_interval = std::chrono::minutes (10);
+	static size_t constexpr unchecked_clear_batch = 4096;
+	static std::chrono::milliseconds constexpr unchecked_clear_interval = std::chrono::milliseconds (50);
+
+private:
+	void unchecked_clear_batch_run (size_t);
 };
 class thread_runner
 {
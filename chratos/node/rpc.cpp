@@ -57,7 +57,9 @@ port (chratos::rpc::rpc_port),
 enable_control (false),
 frontier_request_limit (16384),
 chain_request_limit (16384),
-max_json_depth (20)
+max_json_depth (20),
+wallet_queue_limit (1024),
+async_request_limit (4096)
 {
 }
 
@@ -67,7 +69,9 @@ port (chratos::rpc::rpc_port),
 enable_control (enable_control_a),
 frontier_request_limit (16384),
 chain_request_limit (16384),
-max_json_depth (20)
+max_json_depth (20),
+wallet_queue_limit (1024),
+async_request_limit (4096)
 {
 }
 
@@ -79,6 +83,8 @@ void chratos::rpc_config::serialize_json (boost::property_tree::ptree & tree_a)
 	tree_a.put ("frontier_request_limit", frontier_request_limit);
 	tree_a.put ("chain_request_limit", chain_request_limit);
 	tree_a.put ("max_json_depth", max_json_depth);
+	tree_a.put ("wallet_queue_limit", wallet_queue_limit);
+	tree_a.put ("async_request_limit", async_request_limit);
 }
 
 bool chratos::rpc_config::deserialize_json (boost::property_tree::ptree const & tree_a)
@@ -100,6 +106,8 @@ bool chratos::rpc_config::deserialize_json (boost::property_tree::ptree const &
 			auto frontier_request_limit_l (tree_a.get<std::string> ("frontier_request_limit"));
 			auto chain_request_limit_l (tree_a.get<std::string> ("chain_request_limit"));
 			max_json_depth = tree_a.get<uint8_t> ("max_json_depth", max_json_depth);
+			wallet_queue_limit = tree_a.get<uint64_t> ("wallet_queue_limit", wallet_queue_limit);
+			async_request_limit = tree_a.get<uint64_t> ("async_request_limit", async_request_limit);
 			try
 			{
 				port = std::stoul (port_l);
@@ -129,8 +137,61 @@ bool chratos::rpc_config::deserialize_json (boost::property_tree::ptree const &
 chratos::rpc::rpc (boost::asio::io_service & service_a, chratos::node & node_a, chratos::rpc_config const & config_a) :
 acceptor (service_a),
 config (config_a),
-node (node_a)
+node (node_a),
+requests (std::make_shared<chratos::rpc_requests> (config_a.async_request_limit))
+{
+}
+
+size_t constexpr chratos::rpc_requests::completed_max;
+
+chratos::rpc_requests::rpc_requests (size_t pending_max_a) :
+next (0),
+pending (0),
+pending_max (pending_max_a)
+{
+}
+
+uint64_t chratos::rpc_requests::add ()
+{
+	uint64_t result (0);
+	std::lock_guard<std::mutex> lock (mutex);
+	if (pending < pending_max)
+	{
+		result = ++next;
+		requests[result].done = false;
+		++pending;
+	}
+	return result;
+}
+
+void chratos::rpc_requests::complete (uint64_t id_a, boost::property_tree::ptree const & result_a)
 {
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (requests.find (id_a));
+	if (existing != requests.end () && !existing->second.done)
+	{
+		existing->second.done = true;
+		existing->second.result = result_a;
+		--pending;
+		completed.push_back (id_a);
+		while (completed.size () > completed_max)
+		{
+			requests.erase (completed.front ());
+			completed.pop_front ();
+		}
+	}
+}
+
+bool chratos::rpc_requests::status (uint64_t id_a, chratos::rpc_request_info & info_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (requests.find (id_a));
+	auto result (existing == requests.end ());
+	if (!result)
+	{
+		info_a = existing->second;
+	}
+	return result;
 }
 
 void chratos::rpc::start ()
@@ -360,6 +421,50 @@ uint64_t chratos::rpc_handler::count_impl ()
 	return result;
 }
 
+void chratos::rpc_handler::wallet_locked_impl ()
+{
+	if (node.wallets.initial_unlock_done)
+	{
+		ec = nano::error_common::wallet_locked;
+	}
+	else
+	{
+		ec = nano::error_rpc::node_starting;
+	}
+}
+
+std::function<void(boost::property_tree::ptree const &)> chratos::rpc_handler::tracked_response_impl ()
+{
+	auto result (response);
+	if (!ec)
+	{
+		// Refuse new work rather than let the wallet queue and the connections waiting on it grow without bound
+		if (node.wallets.actions_size () >= rpc.config.wallet_queue_limit)
+		{
+			ec = nano::error_rpc::queue_full;
+		}
+		else if (request.get<bool> ("async", false))
+		{
+			auto requests (rpc.requests);
+			auto id (requests->add ());
+			if (id != 0)
+			{
+				result = [requests, id](boost::property_tree::ptree const & response_a) {
+					requests->complete (id, response_a);
+				};
+				boost::property_tree::ptree response_l;
+				response_l.put ("request", std::to_string (id));
+				response (response_l);
+			}
+			else
+			{
+				ec = nano::error_rpc::queue_full;
+			}
+		}
+	}
+	return result;
+}
+
 uint64_t chratos::rpc_handler::count_optional_impl (uint64_t result)
 {
 	boost::optional<std::string> count_text (request.get_optional<std::string> ("count"));
@@ -373,6 +478,87 @@ uint64_t chratos::rpc_handler::count_optional_impl (uint64_t result)
 	return result;
 }
 
+/*
+ * Reads a page of the unchecked table from the optional "key" start or "hash" dependency, "block", "count" and "type" block type options,
+ * adding "next" to the response when the table has more entries and "next_block" when the page ended inside a key's entries
+ */
+std::vector<std::pair<chratos::block_hash, std::shared_ptr<chratos::block>>> chratos::rpc_handler::unchecked_page_impl ()
+{
+	std::vector<std::pair<chratos::block_hash, std::shared_ptr<chratos::block>>> result;
+	auto count (count_optional_impl ());
+	chratos::block_hash start (0);
+	bool single (false);
+	boost::optional<std::string> key_text (request.get_optional<std::string> ("key"));
+	if (!ec && key_text.is_initialized ())
+	{
+		if (start.decode_hex (key_text.get ()))
+		{
+			ec = nano::error_rpc::bad_key;
+		}
+	}
+	boost::optional<std::string> hash_text (request.get_optional<std::string> ("hash"));
+	if (!ec && hash_text.is_initialized ())
+	{
+		single = true;
+		if (key_text.is_initialized ())
+		{
+			ec = nano::error_rpc::invalid_key_and_hash;
+		}
+		else if (start.decode_hex (hash_text.get ()))
+		{
+			ec = nano::error_blocks::bad_hash_number;
+		}
+	}
+	// Position inside the entries of the starting key, from a previous page's "next_block"
+	chratos::block_hash start_block (0);
+	boost::optional<std::string> block_text (request.get_optional<std::string> ("block"));
+	if (!ec && block_text.is_initialized ())
+	{
+		if (start_block.decode_hex (block_text.get ()))
+		{
+			ec = nano::error_blocks::bad_hash_number;
+		}
+	}
+	auto type (chratos::block_type::invalid);
+	boost::optional<std::string> type_text (request.get_optional<std::string> ("type"));
+	if (!ec && type_text.is_initialized ())
+	{
+		if (type_text.get () == "state")
+		{
+			type = chratos::block_type::state;
+		}
+		else if (type_text.get () == "dividend")
+		{
+			type = chratos::block_type::dividend;
+		}
+		else if (type_text.get () == "claim")
+		{
+			type = chratos::block_type::claim;
+		}
+		else
+		{
+			ec = nano::error_blocks::invalid_type;
+		}
+	}
+	if (!ec)
+	{
+		// Bound the entries a sparse type filter visits per call, the caller resumes from "next"
+		size_t const scan_max (type == chratos::block_type::invalid ? std::numeric_limits<size_t>::max () : 65536);
+		chratos::block_hash next (0);
+		chratos::block_hash next_block (0);
+		chratos::transaction transaction (node.store.environment, nullptr, false);
+		if (node.store.unchecked_page (transaction, start, start_block, count, type, single, scan_max, result, next, next_block))
+		{
+			response_l.put ("next", next.to_string ());
+			if (!next_block.is_zero ())
+			{
+				response_l.put ("next_block", next_block.to_string ());
+			}
+		}
+	}
+	return result;
+}
+
 bool chratos::rpc_handler::rpc_control_impl ()
 {
 	bool result (false);
@@ -471,26 +657,36 @@ void chratos::rpc_handler::account_claim_dividend ()
       {
         if (wallet->store.find (transaction, account) != wallet->store.end ())
         {
-          boost::property_tree::ptree claim;
-
           chratos::account representative (wallet->store.representative (transaction));
           std::shared_ptr<chratos::block> dividend_l (node.store.block_get(transaction, hash));
-          // Check pending and claim outstanding
-          wallet->receive_outstanding_pendings_sync (transaction, account, hash);
           // Check dividend points to the account's last claimed
 
-          if (info.dividend_block == dividend_l->dividend ())
+          if (dividend_l != nullptr && info.dividend_block == dividend_l->dividend ())
           {
-            boost::property_tree::ptree entry;
-            // Claim dividends
-            auto claim_hash = wallet->claim_dividend_sync (dividend_l, account, representative);
-            entry.put ("account", account.to_account ());
-            entry.put ("dividend", hash.to_string ());
-            entry.put ("claim", claim_hash.to_string ());
-            claim.push_back(std::make_pair ("", entry));
-
-            response_l.add_child ("claim", claim);
-
+            auto response_a (tracked_response_impl ());
+            if (!ec)
+            {
+              // Receive outstanding pendings and claim as one chain on the wallet thread
+              wallet->claim_chain_async (account, representative, hash, [response_a, account, hash](std::vector<std::shared_ptr<chratos::block>> blocks_a) {
+                chratos::block_hash claim_hash (0);
+                for (auto & block : blocks_a)
+                {
+                  if (block->type () == chratos::block_type::claim)
+                  {
+                    claim_hash = block->hash ();
+                  }
+                }
+                boost::property_tree::ptree claim;
+                boost::property_tree::ptree entry;
+                entry.put ("account", account.to_account ());
+                entry.put ("dividend", hash.to_string ());
+                entry.put ("claim", claim_hash.to_string ());
+                claim.push_back(std::make_pair ("", entry));
+                boost::property_tree::ptree response_l;
+                response_l.add_child ("claim", claim);
+                response_a (response_l);
+              });
+            }
           }
           else
           {
@@ -509,10 +705,14 @@ void chratos::rpc_handler::account_claim_dividend ()
     }
     else
     {
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
     }
   }
-  response_errors ();
+  // Because of claim_chain_async
+  if (ec)
+  {
+    response_errors ();
+  }
 }
 
 void chratos::rpc_handler::account_claim_all_dividends ()
@@ -528,30 +728,29 @@ void chratos::rpc_handler::account_claim_all_dividends ()
     {
       if (wallet->store.find (transaction, account) != wallet->store.end ())
       {
-        chratos::account_info info;
-        auto ordered = wallet->unclaimed_for_account (account);
-
-        boost::property_tree::ptree claims;
-
         chratos::account representative (wallet->store.representative (transaction));
-        for (auto & hash : ordered)
+        auto response_a (tracked_response_impl ());
+        if (!ec)
         {
-          std::shared_ptr<chratos::block> dividend_l (node.store.block_get(transaction, hash));
-          // Check pending and claim outstanding
-          wallet->receive_outstanding_pendings_sync (transaction, account, hash);
-          // Check dividend points to the account's last claimed
-          chratos::account_info info;
-          node.store.account_get (transaction, account, info);
-          boost::property_tree::ptree entry;
-          // Claim dividends
-          auto claim_hash = wallet->claim_dividend_sync (dividend_l, account, representative);
-          entry.put ("account", account.to_account ());
-          entry.put ("dividend", hash.to_string ());
-          entry.put ("claim", claim_hash.to_string ());
-          claims.push_back(std::make_pair ("", entry));
+          // Every unclaimed dividend and the pendings ahead of each are processed as one chain on the wallet thread
+          wallet->claim_chain_async (account, representative, 0, [response_a, account](std::vector<std::shared_ptr<chratos::block>> blocks_a) {
+            boost::property_tree::ptree claims;
+            for (auto & block : blocks_a)
+            {
+              if (block->type () == chratos::block_type::claim)
+              {
+                boost::property_tree::ptree entry;
+                entry.put ("account", account.to_account ());
+                entry.put ("dividend", block->dividend ().to_string ());
+                entry.put ("claim", block->hash ().to_string ());
+                claims.push_back (std::make_pair ("", entry));
+              }
+            }
+            boost::property_tree::ptree response_l;
+            response_l.add_child ("claims", claims);
+            response_a (response_l);
+          });
         }
-
-        response_l.add_child ("claims", claims);
       }
       else
       {
@@ -560,10 +759,14 @@ void chratos::rpc_handler::account_claim_all_dividends ()
     }
     else
     {
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
     }
   }
-  response_errors ();
+  // Because of claim_chain_async
+  if (ec)
+  {
+    response_errors ();
+  }
 }
 
 void chratos::rpc_handler::account_create ()
@@ -580,7 +783,7 @@ void chratos::rpc_handler::account_create ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	response_errors ();
@@ -622,6 +825,7 @@ void chratos::rpc_handler::account_info ()
 			response_l.put ("balance", balance);
 			response_l.put ("modified_timestamp", std::to_string (info.modified));
 			response_l.put ("block_count", std::to_string (info.block_count));
+			response_l.put ("confirmation_height", std::to_string (node.ledger.confirmation_height (transaction, account)));
 			response_l.put ("account_version", info.epoch == chratos::epoch::epoch_1 ? "1" : "0");
 			if (representative)
 			{
@@ -737,7 +941,7 @@ void chratos::rpc_handler::account_remove ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	response_errors ();
@@ -821,7 +1025,7 @@ void chratos::rpc_handler::account_representative_set ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	// Because of change_async
@@ -1074,6 +1278,19 @@ void chratos::rpc_handler::blocks_info ()
 					std::string contents;
 					block->serialize_json (contents);
 					entry.put ("contents", contents);
+					switch (node.ledger.block_confirmed (transaction, hash))
+					{
+						case chratos::confirmation_status::confirmed:
+							entry.put ("confirmed", "1");
+							break;
+						case chratos::confirmation_status::unconfirmed:
+							entry.put ("confirmed", "0");
+							break;
+						case chratos::confirmation_status::unknown:
+							// Too far from the confirmed frontier to check cheaply
+							entry.put ("confirmed", "unknown");
+							break;
+					}
 					if (pending)
 					{
 						bool exists (false);
@@ -1255,7 +1472,7 @@ void chratos::rpc_handler::block_create ()
 				}
 				else
 				{
-					ec = nano::error_common::wallet_locked;
+					wallet_locked_impl ();
 				}
 			}
 			else
@@ -1365,6 +1582,138 @@ void chratos::rpc_handler::block_create ()
 	response_errors ();
 }
 
+void chratos::rpc_handler::block_create_batch ()
+{
+	rpc_control_impl ();
+	chratos::raw_key prv;
+	prv.data.clear ();
+	if (!ec)
+	{
+		boost::optional<std::string> key_text (request.get_optional<std::string> ("key"));
+		if (key_text.is_initialized ())
+		{
+			if (prv.data.decode_hex (key_text.get ()))
+			{
+				ec = nano::error_common::bad_private_key;
+			}
+		}
+		else
+		{
+			auto wallet (wallet_impl ());
+			auto account (account_impl ());
+			if (!ec)
+			{
+				chratos::transaction transaction (node.store.environment, nullptr, false);
+				if (!wallet->store.valid_password (transaction))
+				{
+					wallet_locked_impl ();
+				}
+				else if (wallet->store.fetch (transaction, account, prv))
+				{
+					ec = nano::error_common::account_not_found_wallet;
+				}
+			}
+		}
+	}
+	chratos::account representative (0);
+	if (!ec && representative.decode_account (request.get<std::string> ("representative")))
+	{
+		ec = nano::error_rpc::bad_representative_number;
+	}
+	chratos::public_key pub (0);
+	chratos::block_hash previous (0);
+	chratos::block_hash dividend (0);
+	if (!ec)
+	{
+		pub = chratos::pub_key (prv.data);
+		chratos::transaction transaction (node.store.environment, nullptr, false);
+		chratos::account_info info;
+		if (!node.store.account_get (transaction, pub, info))
+		{
+			previous = info.head;
+			dividend = info.dividend_block;
+		}
+	}
+	boost::optional<std::string> previous_text (request.get_optional<std::string> ("previous"));
+	if (!ec && previous_text.is_initialized () && previous.decode_hex (previous_text.get ()))
+	{
+		ec = nano::error_rpc::bad_previous;
+	}
+	boost::optional<std::string> dividend_text (request.get_optional<std::string> ("dividend"));
+	if (!ec && dividend_text.is_initialized () && dividend.decode_hex (dividend_text.get ()))
+	{
+		ec = nano::error_rpc::bad_dividend;
+	}
+	// Each entry follows the one before it in the account chain
+	std::vector<std::shared_ptr<chratos::block>> blocks;
+	std::vector<chratos::block_hash> hashes;
+	if (!ec)
+	{
+		for (auto & i : request.get_child ("blocks"))
+		{
+			chratos::amount balance;
+			if (balance.decode_dec (i.second.get<std::string> ("balance")))
+			{
+				ec = nano::error_rpc::invalid_balance;
+				break;
+			}
+			std::string link_text (i.second.get<std::string> ("link"));
+			chratos::uint256_union link;
+			if (link.decode_account (link_text) && link.decode_hex (link_text))
+			{
+				ec = nano::error_rpc::bad_link;
+				break;
+			}
+			chratos::block_hash dividend_l (dividend);
+			boost::optional<std::string> entry_dividend_text (i.second.get_optional<std::string> ("dividend"));
+			if (entry_dividend_text.is_initialized () && dividend_l.decode_hex (entry_dividend_text.get ()))
+			{
+				ec = nano::error_rpc::bad_dividend;
+				break;
+			}
+			auto block (std::make_shared<chratos::state_block> (pub, previous, representative, balance, link, dividend_l, 0));
+			previous = block->hash ();
+			hashes.push_back (previous);
+			blocks.push_back (block);
+		}
+	}
+	if (!ec)
+	{
+		// Every root is known up front so work for the whole batch is generated concurrently
+		std::vector<std::future<uint64_t>> work;
+		if (request.get<bool> ("work", true))
+		{
+			for (auto & i : blocks)
+			{
+				auto promise (std::make_shared<std::promise<uint64_t>> ());
+				work.push_back (promise->get_future ());
+				node.work_generate (i->root (), [promise](uint64_t work_a) {
+					promise->set_value (work_a);
+				});
+			}
+		}
+		std::vector<chratos::signature> signatures (hashes.size ());
+		chratos::sign_message_batch (prv, pub, hashes.data (), hashes.size (), signatures.data ());
+		boost::property_tree::ptree blocks_l;
+		for (size_t i (0), n (blocks.size ()); i < n; ++i)
+		{
+			blocks[i]->signature_set (signatures[i]);
+			if (!work.empty ())
+			{
+				blocks[i]->block_work_set (work[i].get ());
+			}
+			boost::property_tree::ptree entry;
+			entry.put ("hash", hashes[i].to_string ());
+			std::string contents;
+			blocks[i]->serialize_json (contents);
+			entry.put ("block", contents);
+			blocks_l.push_back (std::make_pair ("", entry));
+		}
+		response_l.add_child ("blocks", blocks_l);
+	}
+	response_errors ();
+}
+
 void chratos::rpc_handler::block_hash ()
 {
 	std::string block_text (request.get<std::string> ("block"));
@@ -1509,29 +1858,38 @@ void chratos::rpc_handler::claimed_dividends ()
 
 void chratos::rpc_handler::claim_dividends ()
 {
-
-  boost::property_tree::ptree claims;
-
+  std::vector<std::shared_ptr<chratos::wallet>> wallets;
   for (auto i (node.wallets.items.begin ()), n (node.wallets.items.end ()); i != n; ++i)
   {
-    auto wallet (i->second);
-    auto claimed = wallet->claim_dividends ();
-
-    for (auto & claim : claimed)
-    {
-      boost::property_tree::ptree entry;
-      auto account (claim.account);
-      auto hash (claim.dividend);
-      auto claim_hash (claim.claim);
-      entry.put ("account", account.to_account ());
-      entry.put ("dividend", hash.to_string ());
-      entry.put ("claim", claim_hash.to_string ());
-      claims.push_back(std::make_pair ("", entry));
-    }
+    wallets.push_back (i->second);
+  }
+  auto response_a (tracked_response_impl ());
+  if (!ec)
+  {
+    // Every wallet is claimed in one action on the wallet thread so the claims can't race other wallet actions
+    node.wallets.queue_wallet_action (chratos::wallets::high_priority, [response_a, wallets]() {
+      boost::property_tree::ptree claims;
+      for (auto & wallet : wallets)
+      {
+        for (auto & claim : wallet->claim_dividends_action ())
+        {
+          boost::property_tree::ptree entry;
+          entry.put ("account", claim.account.to_account ());
+          entry.put ("dividend", claim.dividend.to_string ());
+          entry.put ("claim", claim.claim.to_string ());
+          claims.push_back (std::make_pair ("", entry));
+        }
+      }
+      boost::property_tree::ptree response_l;
+      response_l.add_child ("claims", claims);
+      response_a (response_l);
+    });
+  }
+  // Because of queue_wallet_action
+  if (ec)
+  {
+    response_errors ();
   }
-  response_l.add_child ("claims", claims);
-
-  response_errors ();
 }
 
 void chratos::rpc_handler::confirmation_history ()
@@ -2198,6 +2556,11 @@ void chratos::rpc_handler::password_enter ()
 void chratos::rpc_handler::password_valid (bool wallet_locked)
 {
 	auto wallet (wallet_impl ());
+	if (!ec && !node.wallets.initial_unlock_done)
+	{
+		// Wallets with an empty password would briefly read as locked
+		ec = nano::error_rpc::node_starting;
+	}
 	if (!ec)
 	{
 		chratos::transaction transaction (node.store.environment, nullptr, false);
@@ -2383,22 +2746,24 @@ void chratos::rpc_handler::pay_dividend ()
 						boost::optional<std::string> send_id (request.get_optional<std::string> ("id"));
 						if (balance >= amount.number ())
 						{
-							auto rpc_l (shared_from_this ());
-							auto response_a (response);
-              wallet->send_dividend_async (source, amount.number (), [response_a](std::shared_ptr<chratos::block> block_a) {
-								if (block_a != nullptr)
-								{
-									chratos::uint256_union hash (block_a->hash ());
-									boost::property_tree::ptree response_l;
-									response_l.put ("block", hash.to_string ());
-									response_a (response_l);
-								}
-								else
-								{
-									error_response (response_a, "Error generating block");
-								}
-							},
-							work == 0, send_id);
+							auto response_a (tracked_response_impl ());
+							if (!ec)
+							{
+								wallet->send_dividend_async (source, amount.number (), [response_a](std::shared_ptr<chratos::block> block_a) {
+									if (block_a != nullptr)
+									{
+										chratos::uint256_union hash (block_a->hash ());
+										boost::property_tree::ptree response_l;
+										response_l.put ("block", hash.to_string ());
+										response_a (response_l);
+									}
+									else
+									{
+										error_response (response_a, "Error generating block");
+									}
+								},
+								work == 0, send_id);
+							}
 						}
 						else
 						{
@@ -2413,7 +2778,7 @@ void chratos::rpc_handler::pay_dividend ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	// Because of send_async
@@ -2476,7 +2841,7 @@ void chratos::rpc_handler::payment_begin ()
 			}
 			else
 			{
-				ec = nano::error_common::wallet_locked;
+				wallet_locked_impl ();
 			}
 		}
 		else
@@ -2504,7 +2869,7 @@ void chratos::rpc_handler::payment_init ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	response_errors ();
@@ -2579,102 +2944,15 @@ void chratos::rpc_handler::process ()
 	{
 		if (!chratos::work_validate (*block))
 		{
-			auto hash (block->hash ());
-			node.block_arrival.add (hash);
-			chratos::process_return result;
-			{
-				chratos::transaction transaction (node.store.environment, nullptr, true);
-				result = node.block_processor.process_receive_one (transaction, block, std::chrono::steady_clock::time_point ());
-			}
-			switch (result.code)
-			{
-				case chratos::process_result::progress:
-				{
-					response_l.put ("hash", hash.to_string ());
-					break;
-				}
-				case chratos::process_result::gap_previous:
-				{
-					ec = nano::error_process::gap_previous;
-					break;
-				}
-				case chratos::process_result::gap_source:
-				{
-					ec = nano::error_process::gap_source;
-					break;
-				}
-				case chratos::process_result::old:
-				{
-					ec = nano::error_process::old;
-					break;
-				}
-				case chratos::process_result::bad_signature:
-				{
-					ec = nano::error_process::bad_signature;
-					break;
-				}
-				case chratos::process_result::negative_spend:
-				{
-					// TODO once we get RPC versioning, this should be changed to "negative spend"
-					ec = nano::error_process::negative_spend;
-					break;
-				}
-				case chratos::process_result::balance_mismatch:
-				{
-					ec = nano::error_process::balance_mismatch;
-					break;
-				}
-				case chratos::process_result::unreceivable:
-				{
-					ec = nano::error_process::unreceivable;
-					break;
-				}
-				case chratos::process_result::block_position:
-				{
-					ec = nano::error_process::block_position;
-					break;
-				}
-				case chratos::process_result::fork:
-				{
-					const bool force = request.get<bool> ("force", false);
-					if (force && rpc.config.enable_control)
-					{
-						node.active.erase (*block);
-						node.block_processor.force (block);
-						response_l.put ("hash", hash.to_string ());
-					}
-					else
-					{
-						ec = nano::error_process::fork;
-					}
-					break;
-				}
-        case chratos::process_result::dividend_too_small:
-        {
-          ec = nano::error_process::dividend_too_small;
-          break;
-        }
-        case chratos::process_result::dividend_fork:
-        {
-          ec = nano::error_process::dividend_fork;
-          break;
-        }
-        case chratos::process_result::invalid_dividend_account:
-        {
-          ec = nano::error_process::invalid_dividend_account;
-          break;
-        }
-        case chratos::process_result::outstanding_pendings:
-        {
-          ec = nano::error_process::outstanding_pendings;
-          break;
-        }
-				default:
-				{
-					ec = nano::error_process::other;
-					break;
-				}
-			}
+			node.block_arrival.add (block->hash ());
+			// Respond once this block has been processed instead of holding a write transaction on the RPC thread
+			auto rpc_l (shared_from_this ());
+			node.block_processor.add (block, std::chrono::steady_clock::time_point (), [rpc_l, block](chratos::process_return const & result_a) {
+				rpc_l->node.background ([rpc_l, block, result_a]() {
+					rpc_l->process_response (block, result_a);
+					rpc_l->response_errors ();
+				});
+			});
 		}
 		else
 		{
@@ -2685,7 +2963,109 @@ void chratos::rpc_handler::process ()
 	{
 		ec = nano::error_blocks::invalid_block;
 	}
-	response_errors ();
+	if (ec)
+	{
+		response_errors ();
+	}
+}
+
+void chratos::rpc_handler::process_response (std::shared_ptr<chratos::block> block, chratos::process_return const & result)
+{
+	auto hash (block->hash ());
+	switch (result.code)
+	{
+		case chratos::process_result::progress:
+		{
+			response_l.put ("hash", hash.to_string ());
+			break;
+		}
+		case chratos::process_result::gap_previous:
+		{
+			ec = nano::error_process::gap_previous;
+			break;
+		}
+		case chratos::process_result::gap_source:
+		{
+			ec = nano::error_process::gap_source;
+			break;
+		}
+		case chratos::process_result::old:
+		{
+			ec = nano::error_process::old;
+			break;
+		}
+		case chratos::process_result::bad_signature:
+		{
+			ec = nano::error_process::bad_signature;
+			break;
+		}
+		case chratos::process_result::negative_spend:
+		{
+			// TODO once we get RPC versioning, this should be changed to "negative spend"
+			ec = nano::error_process::negative_spend;
+			break;
+		}
+		case chratos::process_result::balance_mismatch:
+		{
+			ec = nano::error_process::balance_mismatch;
+			break;
+		}
+		case chratos::process_result::unreceivable:
+		{
+			ec = nano::error_process::unreceivable;
+			break;
+		}
+		case chratos::process_result::block_position:
+		{
+			ec = nano::error_process::block_position;
+			break;
+		}
+		case chratos::process_result::fork:
+		{
+			const bool force = request.get<bool> ("force", false);
+			if (force && rpc.config.enable_control)
+			{
+				node.active.erase (*block);
+				node.block_processor.force (block);
+				response_l.put ("hash", hash.to_string ());
+			}
+			else
+			{
+				ec = nano::error_process::fork;
+			}
+			break;
+		}
+    case chratos::process_result::dividend_too_small:
+    {
+      ec = nano::error_process::dividend_too_small;
+      break;
+    }
+    case chratos::process_result::dividend_fork:
+    {
+      ec = nano::error_process::dividend_fork;
+      break;
+    }
+    case chratos::process_result::invalid_dividend_account:
+    {
+      ec = nano::error_process::invalid_dividend_account;
+      break;
+    }
+    case chratos::process_result::outstanding_pendings:
+    {
+      ec = nano::error_process::outstanding_pendings;
+      break;
+    }
+    case chratos::process_result::insufficient_work:
+    {
+      ec = nano::error_blocks::work_low;
+      break;
+    }
+		default:
+		{
+			ec = nano::error_process::other;
+			break;
+		}
+	}
 }
 
 void chratos::rpc_handler::receive ()
@@ -2729,9 +3109,9 @@ void chratos::rpc_handler::receive ()
 								ec = nano::error_common::invalid_work;
 							}
 						}
+						auto response_a (tracked_response_impl ());
 						if (!ec)
 						{
-							auto response_a (response);
 							wallet->receive_async (std::move (block), account, chratos::genesis_amount, [response_a](std::shared_ptr<chratos::block> block_a) {
 								chratos::uint256_union hash_a (0);
 								if (block_a != nullptr)
@@ -2762,7 +3142,7 @@ void chratos::rpc_handler::receive ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	// Because of receive_async
@@ -2772,6 +3152,65 @@ void chratos::rpc_handler::receive ()
 	}
 }
 
+void chratos::rpc_handler::receive_all ()
+{
+	rpc_control_impl ();
+	auto wallet (wallet_impl ());
+	auto account (account_impl ());
+	std::vector<chratos::block_hash> sends;
+	chratos::account representative (0);
+	if (!ec)
+	{
+		chratos::transaction transaction (node.store.environment, nullptr, false);
+		if (wallet->store.valid_password (transaction))
+		{
+			if (wallet->store.find (transaction, account) != wallet->store.end ())
+			{
+				representative = wallet->store.representative (transaction);
+				for (auto i (node.store.pending_begin (transaction, chratos::pending_key (account, 0))), n (node.store.pending_begin (transaction, chratos::pending_key (account.number () + 1, 0))); i != n; ++i)
+				{
+					chratos::pending_key key (i->first);
+					chratos::pending_info pending (i->second);
+					if (node.config.receive_minimum.number () <= pending.amount.number ())
+					{
+						sends.push_back (key.hash);
+					}
+				}
+			}
+			else
+			{
+				ec = nano::error_common::account_not_found_wallet;
+			}
+		}
+		else
+		{
+			wallet_locked_impl ();
+		}
+	}
+	auto response_a (tracked_response_impl ());
+	if (!ec)
+	{
+		// Every pending entry is received in one chain instead of a round trip each
+		wallet->receive_chain_async (account, sends, representative, [response_a](std::vector<std::shared_ptr<chratos::block>> blocks_a) {
+			boost::property_tree::ptree response_l;
+			boost::property_tree::ptree blocks;
+			for (auto & i : blocks_a)
+			{
+				boost::property_tree::ptree entry;
+				entry.put ("", i->hash ().to_string ());
+				blocks.push_back (std::make_pair ("", entry));
+			}
+			response_l.add_child ("blocks", blocks);
+			response_a (response_l);
+		});
+	}
+	// Because of receive_chain_async
+	if (ec)
+	{
+		response_errors ();
+	}
+}
+
 void chratos::rpc_handler::receive_minimum ()
 {
 	rpc_control_impl ();
@@ -2844,6 +3283,30 @@ void chratos::rpc_handler::representatives_online ()
 	response_errors ();
 }
 
+void chratos::rpc_handler::request_status ()
+{
+	rpc_control_impl ();
+	if (!ec)
+	{
+		uint64_t id;
+		chratos::rpc_request_info info;
+		if (decode_unsigned (request.get<std::string> ("request"), id) || rpc.requests->status (id, info))
+		{
+			ec = nano::error_rpc::request_not_found;
+		}
+		else if (info.done)
+		{
+			response_l = info.result;
+			response_l.put ("status", "complete");
+		}
+		else
+		{
+			response_l.put ("status", "pending");
+		}
+	}
+	response_errors ();
+}
+
 void chratos::rpc_handler::republish ()
 {
 	auto count (count_optional_impl (1024U));
@@ -2977,7 +3440,18 @@ void chratos::rpc_handler::search_unclaimed_all ()
   rpc_control_impl ();
   if (!ec)
   {
-    auto unclaimed (node.wallets.search_unclaimed_all ());
+    boost::property_tree::ptree accounts;
+    node.wallets.unclaimed_foreach ([&accounts](chratos::account const & account_a, std::vector<chratos::block_hash> const & dividends_a) {
+      boost::property_tree::ptree dividends;
+      for (auto & i : dividends_a)
+      {
+        boost::property_tree::ptree entry;
+        entry.put ("", i.to_string ());
+        dividends.push_back (std::make_pair ("", entry));
+      }
+      accounts.add_child (account_a.to_account (), dividends);
+    });
+    response_l.add_child ("accounts", accounts);
   }
   response_errors ();
 }
@@ -3030,22 +3504,24 @@ void chratos::rpc_handler::send ()
 						boost::optional<std::string> send_id (request.get_optional<std::string> ("id"));
 						if (balance >= amount.number ())
 						{
-							auto rpc_l (shared_from_this ());
-							auto response_a (response);
-							wallet->send_async (source, destination, amount.number (), [response_a](std::shared_ptr<chratos::block> block_a) {
-								if (block_a != nullptr)
-								{
-									chratos::uint256_union hash (block_a->hash ());
-									boost::property_tree::ptree response_l;
-									response_l.put ("block", hash.to_string ());
-									response_a (response_l);
-								}
-								else
-								{
-									error_response (response_a, "Error generating block");
-								}
-							},
-							work == 0, send_id);
+							auto response_a (tracked_response_impl ());
+							if (!ec)
+							{
+								wallet->send_async (source, destination, amount.number (), [response_a](std::shared_ptr<chratos::block> block_a) {
+									if (block_a != nullptr)
+									{
+										chratos::uint256_union hash (block_a->hash ());
+										boost::property_tree::ptree response_l;
+										response_l.put ("block", hash.to_string ());
+										response_a (response_l);
+									}
+									else
+									{
+										error_response (response_a, "Error generating block");
+									}
+								},
+								work == 0, send_id);
+							}
 						}
 						else
 						{
@@ -3065,7 +3541,7 @@ void chratos::rpc_handler::send ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	// Because of send_async
@@ -3075,6 +3551,132 @@ void chratos::rpc_handler::send ()
 	}
 }
 
+void chratos::rpc_handler::send_many ()
+{
+	rpc_control_impl ();
+	auto wallet (wallet_impl ());
+	auto source (account_impl (request.get<std::string> ("source")));
+	std::vector<std::pair<chratos::account, chratos::uint128_t>> destinations;
+	if (!ec)
+	{
+		for (auto & i : request.get_child ("destinations"))
+		{
+			chratos::account destination;
+			chratos::amount amount;
+			if (destination.decode_account (i.second.get<std::string> ("destination")))
+			{
+				ec = nano::error_rpc::bad_destination;
+				break;
+			}
+			if (amount.decode_dec (i.second.get<std::string> ("amount")))
+			{
+				ec = nano::error_common::invalid_amount;
+				break;
+			}
+			destinations.push_back (std::make_pair (destination, amount.number ()));
+		}
+	}
+	if (!ec)
+	{
+		if (wallet->valid_password ())
+		{
+			chratos::transaction transaction (node.store.environment, nullptr, false);
+			if (wallet->store.find (transaction, source) == wallet->store.end ())
+			{
+				ec = nano::error_common::account_not_found_wallet;
+			}
+			else
+			{
+				// The request is all or nothing, refuse it up front if the balance can't cover every destination
+				auto remaining (node.ledger.account_balance (transaction, source));
+				for (auto i (destinations.begin ()), n (destinations.end ()); i != n && !ec; ++i)
+				{
+					if (i->second > remaining)
+					{
+						ec = nano::error_common::insufficient_balance;
+					}
+					else
+					{
+						remaining -= i->second;
+					}
+				}
+			}
+		}
+		else
+		{
+			wallet_locked_impl ();
+		}
+	}
+	auto response_a (tracked_response_impl ());
+	if (!ec)
+	{
+		// Every send is built from one read of the source account and processed as a single chain
+		wallet->send_chain_async (source, destinations, [response_a, destinations](std::vector<std::shared_ptr<chratos::block>> blocks_a) {
+			if (blocks_a.empty ())
+			{
+				error_response (response_a, "Error generating block");
+			}
+			else
+			{
+				boost::property_tree::ptree response_l;
+				boost::property_tree::ptree blocks;
+				for (auto & i : blocks_a)
+				{
+					boost::property_tree::ptree entry;
+					entry.put ("", i->hash ().to_string ());
+					blocks.push_back (std::make_pair ("", entry));
+				}
+				response_l.add_child ("blocks", blocks);
+				if (blocks_a.size () < destinations.size ())
+				{
+					// The ledger rejected a block part way through the chain, nothing after it was sent
+					boost::property_tree::ptree unsent;
+					for (auto i (destinations.begin () + blocks_a.size ()), n (destinations.end ()); i != n; ++i)
+					{
+						boost::property_tree::ptree entry;
+						entry.put ("destination", i->first.to_account ());
+						entry.put ("amount", chratos::amount (i->second).to_string_dec ());
+						unsent.push_back (std::make_pair ("", entry));
+					}
+					response_l.put ("error", "Not all destinations were sent");
+					response_l.add_child ("unsent", unsent);
+				}
+				response_a (response_l);
+			}
+		});
+	}
+	// Because of send_chain_async
+	if (ec)
+	{
+		response_errors ();
+	}
+}
+
+void chratos::rpc_handler::send_id_lookup ()
+{
+	std::string id (request.get<std::string> ("id"));
+	auto existing (node.wallets.send_ids.find (id));
+	chratos::transaction transaction (node.store.environment, nullptr, false);
+	// The block may have been rolled back since the ID was recorded
+	if (existing && node.store.block_exists (transaction, *existing))
+	{
+		response_l.put ("block", existing->to_string ());
+	}
+	else
+	{
+		ec = nano::error_blocks::not_found;
+	}
+	response_errors ();
+}
+
+void chratos::rpc_handler::startup_profile ()
+{
+	node.startup.serialize (response_l);
+	// Lets clients poll for readiness instead of retrying wallet requests
+	response_l.put ("wallets_unlocked", node.wallets.initial_unlock_done ? "1" : "0");
+	response_errors ();
+}
+
 void chratos::rpc_handler::stats ()
 {
 	auto sink = node.stats.log_sink_json ();
@@ -3118,14 +3720,13 @@ void chratos::rpc_handler::stop ()
 
 void chratos::rpc_handler::unchecked ()
 {
-	auto count (count_optional_impl ());
+	auto page (unchecked_page_impl ());
 	if (!ec)
 	{
 		boost::property_tree::ptree unchecked;
-		chratos::transaction transaction (node.store.environment, nullptr, false);
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		for (auto & i : page)
 		{
-			auto block (i->second);
+			auto block (i.second);
 			std::string contents;
 			block->serialize_json (contents);
 			unchecked.put (block->hash ().to_string (), contents);
@@ -3140,9 +3741,10 @@ void chratos::rpc_handler::unchecked_clear ()
 	rpc_control_impl ();
 	if (!ec)
 	{
-		chratos::transaction transaction (node.store.environment, nullptr, true);
-		node.store.unchecked_clear (transaction);
+		// Entries are removed in batches in the background, block_count reports the remaining "unchecked"
+		auto running (node.unchecked_clear_background ());
 		response_l.put ("success", "");
+		response_l.put ("started", running ? "0" : "1");
 	}
 	response_errors ();
 }
@@ -3174,27 +3776,17 @@ void chratos::rpc_handler::unchecked_get ()
 
 void chratos::rpc_handler::unchecked_keys ()
 {
-	auto count (count_optional_impl ());
-	chratos::uint256_union key (0);
-	boost::optional<std::string> hash_text (request.get_optional<std::string> ("key"));
-	if (!ec && hash_text.is_initialized ())
-	{
-		if (key.decode_hex (hash_text.get ()))
-		{
-			ec = nano::error_rpc::bad_key;
-		}
-	}
+	auto page (unchecked_page_impl ());
 	if (!ec)
 	{
 		boost::property_tree::ptree unchecked;
-		chratos::transaction transaction (node.store.environment, nullptr, false);
-		for (auto i (node.store.unchecked_begin (transaction, key)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		for (auto & i : page)
 		{
 			boost::property_tree::ptree entry;
-			auto block (i->second);
+			auto block (i.second);
 			std::string contents;
 			block->serialize_json (contents);
-			entry.put ("key", chratos::block_hash (i->first).to_string ());
+			entry.put ("key", i.first.to_string ());
 			entry.put ("hash", block->hash ().to_string ());
 			entry.put ("contents", contents);
 			unchecked.push_back (std::make_pair ("", entry));
@@ -3239,7 +3831,7 @@ void chratos::rpc_handler::wallet_add ()
 			}
 			else
 			{
-				ec = nano::error_common::wallet_locked;
+				wallet_locked_impl ();
 			}
 		}
 		else
@@ -3271,7 +3863,7 @@ void chratos::rpc_handler::wallet_add_watch ()
 		}
 		else
 		{
-			ec = nano::error_common::wallet_locked;
+			wallet_locked_impl ();
 		}
 	}
 	response_errors ();
@@ -3359,7 +3951,7 @@ void chratos::rpc_handler::wallet_change_seed ()
 			}
 			else
 			{
-				ec = nano::error_common::wallet_locked;
+				wallet_locked_impl ();
 			}
 		}
 		else
@@ -3581,9 +4173,7 @@ void chratos::rpc_handler::wallet_lock ()
 	auto wallet (wallet_impl ());
 	if (!ec)
 	{
-		chratos::raw_key empty;
-		empty.data.clear ();
-		wallet->store.password.value_set (empty);
+		wallet->store.lock ();
 		response_l.put ("locked", "1");
 	}
 	response_errors ();
@@ -4151,6 +4741,10 @@ void chratos::rpc_handler::process_request ()
 			{
 				block_create ();
 			}
+			else if (action == "block_create_batch")
+			{
+				block_create_batch ();
+			}
 			else if (action == "block_hash")
 			{
 				block_hash ();
@@ -4316,6 +4910,10 @@ void chratos::rpc_handler::process_request ()
 			{
 				receive ();
 			}
+			else if (action == "receive_all")
+			{
+				receive_all ();
+			}
 			else if (action == "receive_minimum")
 			{
 				receive_minimum ();
@@ -4336,6 +4934,10 @@ void chratos::rpc_handler::process_request ()
 			{
 				republish ();
 			}
+			else if (action == "request_status")
+			{
+				request_status ();
+			}
 			else if (action == "search_pending")
 			{
 				search_pending ();
@@ -4348,6 +4950,18 @@ void chratos::rpc_handler::process_request ()
 			{
 				send ();
 			}
+			else if (action == "send_many")
+			{
+				send_many ();
+			}
+			else if (action == "send_id_lookup")
+			{
+				send_id_lookup ();
+			}
+			else if (action == "startup_profile")
+			{
+				startup_profile ();
+			}
 			else if (action == "stats")
 			{
 				stats ();
@@ -6,11 +6,14 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <chratos/secure/utility.hpp>
+#include <deque>
 #include <unordered_map>
 
 namespace chratos
 {
 void error_response (std::function<void(boost::property_tree::ptree const &)> response_a, std::string const & message_a);
+class block;
+class process_return;
 class node;
 /** Configuration options for RPC TLS */
 class rpc_secure_config
@@ -49,6 +52,10 @@ public:
 	uint64_t chain_request_limit;
 	rpc_secure_config secure;
 	uint8_t max_json_depth;
+	// Wallet actions that may be queued before block creating requests are refused
+	uint64_t wallet_queue_limit;
+	// Fire-and-track requests that may be outstanding at once
+	uint64_t async_request_limit;
 };
 enum class payment_status
 {
@@ -61,6 +68,33 @@ enum class payment_status
 	success // Amount received
 };
 class wallet;
+class rpc_request_info
+{
+public:
+	bool done;
+	boost::property_tree::ptree result;
+};
+/**
+ * Outcome of block creating requests made with "async", which are answered with a handle as soon as they're queued.
+ * Completed results are kept for request_status until completed_max newer ones have finished.
+ */
+class rpc_requests
+{
+public:
+	rpc_requests (size_t);
+	// Returns zero if pending_max requests are already outstanding
+	uint64_t add ();
+	void complete (uint64_t, boost::property_tree::ptree const &);
+	// Returns true if the request is unknown
+	bool status (uint64_t, rpc_request_info &);
+	std::mutex mutex;
+	std::unordered_map<uint64_t, chratos::rpc_request_info> requests;
+	std::deque<uint64_t> completed;
+	uint64_t next;
+	size_t pending;
+	size_t pending_max;
+	static size_t constexpr completed_max = 64 * 1024;
+};
 class payment_observer;
 class rpc
 {
@@ -75,6 +109,7 @@ public:
 	std::unordered_map<chratos::account, std::shared_ptr<chratos::payment_observer>> payment_observers;
 	chratos::rpc_config config;
 	chratos::node & node;
+	std::shared_ptr<chratos::rpc_requests> requests;
 	bool on;
 	static uint16_t const rpc_port = chratos::chratos_network == chratos::chratos_networks::chratos_live_network ? 9126 : 45000;
 };
@@ -145,6 +180,7 @@ public:
 	void block_count ();
 	void block_count_type ();
 	void block_create ();
+	void block_create_batch ();
 	void block_hash ();
 	void bootstrap ();
 	void bootstrap_any ();
@@ -179,16 +215,22 @@ public:
 	void pending ();
 	void pending_exists ();
 	void process ();
+	void process_response (std::shared_ptr<chratos::block>, chratos::process_return const &);
 	void receive ();
+	void receive_all ();
 	void receive_minimum ();
 	void receive_minimum_set ();
 	void representatives ();
 	void representatives_online ();
 	void republish ();
+	void request_status ();
 	void search_pending ();
 	void search_pending_all ();
   void search_unclaimed_all ();
 	void send ();
+	void send_many ();
+	void send_id_lookup ();
+	void startup_profile ();
 	void stats ();
 	void stop ();
 	void unchecked ();
@@ -243,6 +285,10 @@ public:
 	uint64_t count_impl ();
 	uint64_t count_optional_impl (uint64_t = std::numeric_limits<uint64_t>::max ());
 	bool rpc_control_impl ();
+	// Report a locked wallet, or a retryable error while startup is still unlocking the wallets
+	void wallet_locked_impl ();
+	std::function<void(boost::property_tree::ptree const &)> tracked_response_impl ();
+	std::vector<std::pair<chratos::block_hash, std::shared_ptr<chratos::block>>> unchecked_page_impl ();
 };
 /** Returns the correct RPC implementation based on TLS configuration */
 std::unique_ptr<chratos::rpc> get_rpc (boost::asio::io_service & service_a, chratos::node & node_a, chratos::rpc_config const & config_a);
@@ -1,6 +1,7 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <cstdlib>
+#include <random>
 #include <chratos/node/common.hpp>
 #include <chratos/node/testing.hpp>
 
@@ -357,6 +358,243 @@ void chratos::system::stop ()
 	work.stop ();
 }
 
+size_t constexpr chratos::ledger_generator::representatives_max;
+
+chratos::ledger_generator::ledger_generator (chratos::ledger & ledger_a, chratos::ledger_generator_config const & config_a) :
+ledger (ledger_a),
+config (config_a),
+seed (config_a.seed),
+dividend_head (chratos::dividend_base)
+{
+	genesis_prv.data = chratos::test_genesis_key.prv.data;
+	dividend_prv.data = chratos::test_dividend_key.prv.data;
+	config.batch_size = std::max<uint64_t> (1, config.batch_size);
+	config.threads = std::max (1u, config.threads);
+}
+
+bool chratos::ledger_generator::generate ()
+{
+	auto error (chratos::chratos_network != chratos::chratos_networks::chratos_test_network);
+	if (error)
+	{
+		std::cerr << "Ledger generation needs the test network genesis and dividend keys\n";
+	}
+	else
+	{
+		chratos::transaction transaction (ledger.store.environment, nullptr, false);
+		chratos::account_info info;
+		error = ledger.store.account_count (transaction) != 1 || ledger.store.account_get (transaction, chratos::genesis_account, info) || info.block_count != 1;
+		if (error)
+		{
+			std::cerr << "Ledger generation needs a ledger holding only the genesis block\n";
+		}
+		else
+		{
+			genesis.account = chratos::genesis_account;
+			genesis.head = info.head;
+			genesis.representative = chratos::genesis_account;
+			genesis.balance = info.balance.number ();
+			genesis.dividend = info.dividend_block;
+			dividend_head = ledger.store.dividend_get (transaction).head;
+		}
+	}
+	std::mt19937_64 random (config.seed);
+	if (!error && config.dividend_interval != 0)
+	{
+		// Half the supply funds the dividend account, each dividend pays out a fixed slice of the genesis amount
+		dividend.account = chratos::test_dividend_key.pub;
+		dividend.representative = chratos::genesis_account;
+		dividend.balance = chratos::genesis_amount / 2;
+		dividend.dividend = dividend_head;
+		auto source (send (genesis, genesis_prv, dividend.account, dividend.balance));
+		auto open (std::make_shared<chratos::state_block> (dividend.account, 0, dividend.representative, dividend.balance, source, dividend.dividend, 0));
+		dividend.head = open->hash ();
+		queue (open, dividend_prv, dividend.account);
+	}
+	std::geometric_distribution<uint64_t> chain_lengths (1.0 / std::max<uint64_t> (1, config.chain_length));
+	std::uniform_real_distribution<double> claim_draw (0.0, 1.0);
+	for (uint64_t i (0); !error && i < config.accounts; ++i)
+	{
+		chratos::raw_key prv;
+		chratos::deterministic_key (seed, i, prv.data);
+		chratos::ledger_generator::chain_state state;
+		state.account = chratos::pub_key (prv.data);
+		state.representative = representatives.empty () ? chratos::genesis_account : representatives[random () % representatives.size ()];
+		state.balance = (random () % 1000 + 1) * chratos::kchr_ratio;
+		state.dividend = dividend_head;
+		auto source (send (genesis, genesis_prv, state.account, state.balance));
+		auto open (std::make_shared<chratos::state_block> (state.account, 0, state.representative, state.balance, source, state.dividend, 0));
+		state.head = open->hash ();
+		queue (open, prv, state.account);
+		// Extra blocks are self sends received straight away so no pending entries hold up later claims, an odd one out changes representative
+		for (auto extra (chain_lengths (random)); extra > 0;)
+		{
+			if (extra >= 2)
+			{
+				auto amount (state.balance / (random () % 8 + 2));
+				auto link (send (state, prv, state.account, amount));
+				state.balance += amount;
+				auto receive (std::make_shared<chratos::state_block> (state.account, state.head, state.representative, state.balance, link, state.dividend, 0));
+				state.head = receive->hash ();
+				queue (receive, prv, state.account);
+				extra -= 2;
+			}
+			else
+			{
+				state.representative = representatives.empty () ? chratos::genesis_account : representatives[random () % representatives.size ()];
+				auto change (std::make_shared<chratos::state_block> (state.account, state.head, state.representative, state.balance, 0, state.dividend, 0));
+				state.head = change->hash ();
+				queue (change, prv, state.account);
+				extra -= 1;
+			}
+		}
+		++accounts;
+		if (representatives.size () < representatives_max)
+		{
+			representatives.push_back (state.account);
+		}
+		if (claim_draw (random) < config.claim_ratio)
+		{
+			claimers.push_back (std::make_pair (i, state.account));
+		}
+		if (queued.size () >= config.batch_size)
+		{
+			error = flush ();
+		}
+		if (!error && config.dividend_interval != 0 && (i + 1) % config.dividend_interval == 0)
+		{
+			error = issue_dividend ();
+		}
+	}
+	if (!error)
+	{
+		error = flush ();
+	}
+	return error;
+}
+
+chratos::block_hash chratos::ledger_generator::send (chratos::ledger_generator::chain_state & state_a, chratos::raw_key const & prv_a, chratos::account const & destination_a, chratos::uint128_t const & amount_a)
+{
+	assert (state_a.balance >= amount_a);
+	state_a.balance -= amount_a;
+	auto block (std::make_shared<chratos::state_block> (state_a.account, state_a.head, state_a.representative, state_a.balance, destination_a, state_a.dividend, 0));
+	state_a.head = block->hash ();
+	queue (block, prv_a, state_a.account);
+	return state_a.head;
+}
+
+void chratos::ledger_generator::queue (std::shared_ptr<chratos::block> block_a, chratos::raw_key const & prv_a, chratos::public_key const & pub_a)
+{
+	chratos::ledger_generator::queued_block queued_l;
+	queued_l.block = block_a;
+	queued_l.prv.data = prv_a.data;
+	queued_l.pub = pub_a;
+	queued.push_back (queued_l);
+}
+
+bool chratos::ledger_generator::issue_dividend ()
+{
+	auto amount (chratos::genesis_amount / 1024);
+	auto error (dividend.balance < amount);
+	if (!error)
+	{
+		// Claims are computed from the committed ledger so everything queued so far has to land first
+		dividend.balance -= amount;
+		auto block (std::make_shared<chratos::dividend_block> (dividend.account, dividend.head, dividend.representative, dividend.balance, dividend_head, dividend_prv, dividend.account, 0));
+		dividend.head = block->hash ();
+		queue (block, dividend_prv, dividend.account);
+		error = flush ();
+		if (!error)
+		{
+			dividend_head = dividend.head;
+			++dividends;
+			for (size_t i (0), n (claimers.size ()); !error && i < n;)
+			{
+				{
+					chratos::transaction transaction (ledger.store.environment, nullptr, false);
+					for (; i < n && queued.size () < config.batch_size; ++i)
+					{
+						chratos::account_info info;
+						auto & claimer (claimers[i]);
+						auto missing (ledger.store.account_get (transaction, claimer.second, info));
+						assert (!missing);
+						auto rep_block (ledger.store.block_get (transaction, info.rep_block));
+						auto reward (ledger.dividend_reward (transaction, dividend_head, info.balance));
+						chratos::raw_key prv;
+						chratos::deterministic_key (seed, claimer.first, prv.data);
+						auto claim (std::make_shared<chratos::claim_block> (claimer.second, info.head, rep_block->representative (), info.balance.number () + reward.number (), dividend_head, 0));
+						queue (claim, prv, claimer.second);
+						++claims;
+					}
+				}
+				error = flush ();
+			}
+		}
+	}
+	else
+	{
+		// Out of dividend funds, keep generating accounts without further dividends
+		config.dividend_interval = 0;
+		error = false;
+	}
+	return error;
+}
+
+bool chratos::ledger_generator::flush ()
+{
+	// Sign on worker threads, batching runs of blocks from the same account, then process everything in one write transaction
+	auto sign ([this](size_t begin_a, size_t end_a) {
+		std::vector<chratos::uint256_union> hashes;
+		std::vector<chratos::uint512_union> signatures;
+		for (auto i (begin_a); i < end_a;)
+		{
+			auto j (i);
+			hashes.clear ();
+			for (; j < end_a && queued[j].pub == queued[i].pub; ++j)
+			{
+				hashes.push_back (queued[j].block->hash ());
+			}
+			signatures.resize (hashes.size ());
+			chratos::sign_message_batch (queued[i].prv, queued[i].pub, hashes.data (), hashes.size (), signatures.data ());
+			for (auto k (i); k < j; ++k)
+			{
+				queued[k].block->signature_set (signatures[k - i]);
+			}
+			i = j;
+		}
+	});
+	std::vector<std::thread> workers;
+	auto slice ((queued.size () + config.threads - 1) / config.threads);
+	for (size_t begin (slice); begin < queued.size (); begin += slice)
+	{
+		workers.emplace_back (sign, begin, std::min (queued.size (), begin + slice));
+	}
+	sign (0, std::min (queued.size (), slice));
+	for (auto & worker : workers)
+	{
+		worker.join ();
+	}
+	auto error (false);
+	{
+		chratos::transaction transaction (ledger.store.environment, nullptr, true);
+		for (auto i (queued.begin ()), n (queued.end ()); !error && i != n; ++i)
+		{
+			auto result (ledger.process (transaction, *i->block));
+			error = result.code != chratos::process_result::progress;
+			if (error)
+			{
+				std::cerr << boost::str (boost::format ("Generated block %1% was rejected with code %2%\n") % i->block->hash ().to_string () % static_cast<int> (result.code));
+			}
+			else
+			{
+				++blocks;
+			}
+		}
+	}
+	queued.clear ();
+	return error;
+}
+
 chratos::landing_store::landing_store ()
 {
 }
@@ -46,6 +46,69 @@ public:
 	std::chrono::time_point<std::chrono::steady_clock, std::chrono::duration<double>> deadline{ std::chrono::steady_clock::time_point::max () };
 	double deadline_scaling_factor{ 1.0 };
 };
+class ledger_generator_config
+{
+public:
+	uint64_t accounts{ 1000 };
+	/** Mean number of blocks in each generated account chain, the lengths follow a geometric distribution */
+	uint64_t chain_length{ 4 };
+	/** Accounts opened between dividends, 0 disables dividends */
+	uint64_t dividend_interval{ 0 };
+	/** Fraction of accounts that claim every dividend issued after they open */
+	double claim_ratio{ 0.5 };
+	uint64_t batch_size{ 64 * 1024 };
+	unsigned threads{ 1 };
+	uint64_t seed{ 0 };
+};
+/**
+ * Writes a deterministic ledger directly through ledger::process in large write batches so storage can be benchmarked at scale.
+ * Only available on the test network where the genesis and dividend keys are known. Blocks carry no work since the ledger doesn't check it.
+ */
+class ledger_generator
+{
+public:
+	ledger_generator (chratos::ledger &, chratos::ledger_generator_config const &);
+	/** Returns true on error */
+	bool generate ();
+	uint64_t blocks{ 0 };
+	uint64_t accounts{ 0 };
+	uint64_t dividends{ 0 };
+	uint64_t claims{ 0 };
+
+private:
+	class chain_state
+	{
+	public:
+		chratos::account account;
+		chratos::block_hash head;
+		chratos::account representative;
+		chratos::uint128_t balance;
+		chratos::block_hash dividend;
+	};
+	class queued_block
+	{
+	public:
+		std::shared_ptr<chratos::block> block;
+		chratos::raw_key prv;
+		chratos::public_key pub;
+	};
+	chratos::block_hash send (chratos::ledger_generator::chain_state &, chratos::raw_key const &, chratos::account const &, chratos::uint128_t const &);
+	void queue (std::shared_ptr<chratos::block>, chratos::raw_key const &, chratos::public_key const &);
+	bool issue_dividend ();
+	bool flush ();
+	chratos::ledger & ledger;
+	chratos::ledger_generator_config config;
+	chratos::uint256_union seed;
+	chratos::raw_key genesis_prv;
+	chratos::raw_key dividend_prv;
+	chratos::ledger_generator::chain_state genesis;
+	chratos::ledger_generator::chain_state dividend;
+	chratos::block_hash dividend_head;
+	std::vector<chratos::account> representatives;
+	std::vector<std::pair<uint64_t, chratos::account>> claimers;
+	std::vector<chratos::ledger_generator::queued_block> queued;
+	static size_t constexpr representatives_max = 32;
+};
 class landing_store
 {
 public:
@@ -7,6 +7,7 @@
 
 #include <argon2.h>
 
+#include <boost/endian/conversion.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -141,6 +142,10 @@ bool chratos::wallet_store::attempt_password (MDB_txn * transaction_a, std::stri
     derive_key (password_l, transaction_a, password_a);
     password.value_set (password_l);
     result = !valid_password (transaction_a);
+    if (result)
+    {
+      expanded_keys.clear ();
+    }
   }
   if (!result)
   {
@@ -431,6 +436,8 @@ void chratos::wallet_store::erase (MDB_txn * transaction_a, chratos::public_key
 {
   auto status (mdb_del (transaction_a, handle, chratos::mdb_val (pub), nullptr));
   assert (status == 0);
+  std::lock_guard<std::recursive_mutex> lock (mutex);
+  expanded_keys.erase (pub);
 }
 
 chratos::wallet_value chratos::wallet_store::entry_get_raw (MDB_txn * transaction_a, chratos::public_key const & pub_a)
@@ -532,6 +539,43 @@ bool chratos::wallet_store::fetch (MDB_txn * transaction_a, chratos::public_key
   return result;
 }
 
+bool chratos::wallet_store::fetch (MDB_txn * transaction_a, chratos::public_key const & pub, chratos::expanded_key & prv)
+{
+  std::lock_guard<std::recursive_mutex> lock (mutex);
+  auto result (!valid_password (transaction_a));
+  if (!result)
+  {
+    auto existing (expanded_keys.find (pub));
+    if (existing == expanded_keys.end ())
+    {
+      chratos::raw_key prv_l;
+      result = fetch (transaction_a, pub, prv_l);
+      if (!result)
+      {
+        existing = expanded_keys.emplace (pub, chratos::expanded_key (prv_l)).first;
+      }
+    }
+    if (!result)
+    {
+      prv = existing->second;
+    }
+  }
+  else
+  {
+    expanded_keys.clear ();
+  }
+  return result;
+}
+
+void chratos::wallet_store::lock ()
+{
+  std::lock_guard<std::recursive_mutex> lock (mutex);
+  chratos::raw_key empty;
+  empty.data.clear ();
+  password.value_set (empty);
+  expanded_keys.clear ();
+}
+
 bool chratos::wallet_store::exists (MDB_txn * transaction_a, chratos::public_key const & pub)
 {
   return !pub.is_zero () && find (transaction_a, pub) != end ();
@@ -957,15 +1001,9 @@ std::shared_ptr<chratos::block> chratos::wallet::receive_action (chratos::block
   }
   if (block != nullptr)
   {
-    if (chratos::work_validate (*block))
-    {
-      node.work_generate_blocking (*block);
-    }
-    node.process_active (block);
-    node.block_processor.flush ();
-    if (generate_work_a)
+    if (action_process (block, account, generate_work_a))
     {
-      work_ensure (account, block->hash ());
+      block = nullptr;
     }
   }
   return block;
@@ -995,15 +1033,9 @@ std::shared_ptr<chratos::block> chratos::wallet::change_action (chratos::account
   }
   if (block != nullptr)
   {
-    if (chratos::work_validate (*block))
+    if (action_process (block, source_a, generate_work_a))
     {
-      node.work_generate_blocking (*block);
-    }
-    node.process_active (block);
-    node.block_processor.flush ();
-    if (generate_work_a)
-    {
-      work_ensure (source_a, block->hash ());
+      block = nullptr;
     }
   }
   return block;
@@ -1012,33 +1044,23 @@ std::shared_ptr<chratos::block> chratos::wallet::change_action (chratos::account
 std::shared_ptr<chratos::block> chratos::wallet::send_action (chratos::account const & source_a, chratos::account const & account_a, chratos::uint128_t const & amount_a, bool generate_work_a, boost::optional<std::string> id_a)
 {
   std::shared_ptr<chratos::block> block;
-  boost::optional<chratos::mdb_val> id_mdb_val;
-  if (id_a)
-  {
-    id_mdb_val = chratos::mdb_val (id_a->size (), const_cast<char *> (id_a->data ()));
-  }
   bool error = false;
   bool cached_block = false;
   {
-    chratos::transaction transaction (store.environment, nullptr, (bool)id_mdb_val);
-    if (id_mdb_val)
+    // Known IDs are answered from the in-memory index, a write transaction is only needed to record a new one
+    chratos::transaction transaction (store.environment, nullptr, false);
+    if (id_a)
     {
-      chratos::mdb_val result;
-      auto status (mdb_get (transaction, node.wallets.send_action_ids, *id_mdb_val, result));
-      if (status == 0)
+      auto existing (node.wallets.send_ids.find (*id_a));
+      if (existing)
       {
-        chratos::uint256_union hash (result);
-        block = node.store.block_get (transaction, hash);
+        block = node.store.block_get (transaction, *existing);
         if (block != nullptr)
         {
           cached_block = true;
           node.network.republish_block (transaction, block);
         }
       }
-      else if (status != MDB_NOTFOUND)
-      {
-        error = true;
-      }
     }
     if (!error && block == nullptr)
     {
@@ -1064,31 +1086,25 @@ std::shared_ptr<chratos::block> chratos::wallet::send_action (chratos::account c
             uint64_t cached_work (0);
             store.work_get (transaction, source_a, cached_work);
             block.reset (new chratos::state_block (source_a, info.head, rep_block->representative (), balance - amount_a, account_a, div_info.head, prv, source_a, cached_work));
-            if (id_mdb_val && block != nullptr)
-            {
-              auto status (mdb_put (transaction, node.wallets.send_action_ids, *id_mdb_val, chratos::mdb_val (block->hash ()), 0));
-              if (status != 0)
-              {
-                block = nullptr;
-                error = true;
-              }
-            }
           }
         }
       }
     }
   }
-  if (!error && block != nullptr && !cached_block)
+  if (id_a && block != nullptr && !cached_block)
   {
-    if (chratos::work_validate (*block))
+    chratos::transaction transaction (store.environment, nullptr, true);
+    if (node.wallets.send_ids.put (transaction, node.wallets.send_action_ids, *id_a, block->hash ()))
     {
-      node.work_generate_blocking (*block);
+      block = nullptr;
+      error = true;
     }
-    node.process_active (block);
-    node.block_processor.flush ();
-    if (generate_work_a)
+  }
+  if (!error && block != nullptr && !cached_block)
+  {
+    if (action_process (block, source_a, generate_work_a))
     {
-      work_ensure (source_a, block->hash ());
+      block = nullptr;
     }
   }
   return block;
@@ -1165,88 +1181,14 @@ std::shared_ptr<chratos::block> chratos::wallet::pay_dividend_action (chratos::a
   }
   if (!error && block != nullptr && !cached_block)
   {
-    if (chratos::work_validate (*block))
+    if (action_process (block, source_a, generate_work_a))
     {
-      node.work_generate_blocking (*block);
-    }
-    node.process_active (block);
-    node.block_processor.flush ();
-    if (generate_work_a)
-    {
-      work_ensure (source_a, block->hash ());
+      block = nullptr;
     }
   }
   return block;
 }
 
-std::shared_ptr<chratos::block> chratos::wallet::claim_dividend_action (chratos::block const & dividend_a, chratos::account const & account_a, chratos::account const & representative_a, bool generate_work_a) {
-  auto hash (dividend_a.hash ());
-  std::shared_ptr<chratos::block> block;
-  std::shared_ptr<chratos::block> dividend_block;
-  chratos::account_info account_info;
-
-  chratos::transaction transaction (node.ledger.store.environment, nullptr, false);
-
-  if (node.store.block_exists (transaction, hash))
-  {
-    dividend_block = node.store.block_get (transaction, hash);
-    if (!has_outstanding_pendings_for_dividend (transaction, dividend_block, account_a))
-    {
-      if (!node.ledger.store.account_get (transaction, account_a, account_info))
-      {
-        if (dividend_block->dividend () == account_info.dividend_block)
-        {
-          chratos::raw_key prv;
-          if (!store.fetch (transaction, account_a, prv))
-          {
-            chratos::amount amount (amount_for_dividend (transaction, dividend_block, account_a));
-            uint64_t cached_work (0);
-            store.work_get (transaction, account_a, cached_work);
-            std::shared_ptr<chratos::block> rep_block = node.ledger.store.block_get (transaction, account_info.rep_block);
-            assert (rep_block != nullptr);
-            block.reset (new chratos::claim_block (account_a, account_info.head, rep_block->representative (), account_info.balance.number () + amount.number (), hash, prv, account_a, cached_work));
-          }
-          else
-          {
-            BOOST_LOG (node.log) << "Unable to receive, wallet locked";
-          }
-        }
-        else
-        {
-          // Ledger doesn't have this marked as available to receive anymore
-        }
-      }
-      else
-      {
-        // We have old unclaimed dividends
-      }
-    }
-    else
-    {
-      // We have unclaimed pendings
-    }
-  }
-  else
-  {
-    // Ledger doesn't have this block anymore.
-  }
-  if (block != nullptr)
-  {
-    if (chratos::work_validate (*block))
-    {
-      node.work_generate_blocking (*block);
-    }
-    node.process_active (block);
-    node.block_processor.flush ();
-    if (generate_work_a)
-    {
-      work_ensure (account_a, block->hash ());
-    }
-  }
-  return block;
-
-}
-
 bool chratos::wallet::change_sync (chratos::account const & source_a, chratos::account const & representative_a)
 {
   std::promise<bool> result;
@@ -1318,22 +1260,6 @@ void chratos::wallet::send_dividend_async (chratos::account const & source_a, ch
   });
 }
 
-chratos::block_hash chratos::wallet::claim_dividend_sync (std::shared_ptr<chratos::block> dividend_a, chratos::account const & account_a, chratos::account const & representative_a) { 
-  std::promise<chratos::block_hash> result;
-  claim_dividend_async (dividend_a, account_a, representative_a, [&result](std::shared_ptr<chratos::block> block_a) {
-    result.set_value (block_a->hash ());
-  },
-  true);
-  return result.get_future ().get ();
-}
-
-void chratos::wallet::claim_dividend_async (std::shared_ptr<chratos::block> dividend_a, chratos::account const & account_a, chratos::account const & representative_a, std::function<void(std::shared_ptr<chratos::block>)> const & action_a, bool generate_work_a) {
-  node.wallets.queue_wallet_action (chratos::wallets::high_priority, [this, dividend_a, account_a, representative_a, action_a, generate_work_a]() {
-    auto block (claim_dividend_action (*static_cast<chratos::block *> (dividend_a.get ()), account_a, representative_a, generate_work_a));
-    action_a (block);
-  });
-}
-
 // Update work for account if latest root is root_a
 void chratos::wallet::work_update (MDB_txn * transaction_a, chratos::account const & account_a, chratos::block_hash const & root_a, uint64_t work_a)
 {
@@ -1350,6 +1276,26 @@ void chratos::wallet::work_update (MDB_txn * transaction_a, chratos::account con
   }
 }
 
+bool chratos::wallet::action_process (std::shared_ptr<chratos::block> const & block_a, chratos::account const & account_a, bool generate_work_a)
+{
+  if (chratos::work_validate (*block_a))
+  {
+    node.work_generate_blocking (*block_a);
+  }
+  chratos::process_return result;
+  auto error (node.process_local (block_a, result));
+  if (!error && result.code != chratos::process_result::progress && result.code != chratos::process_result::old)
+  {
+    BOOST_LOG (node.log) << boost::str (boost::format ("Block %1% for account %2% was rejected by the ledger") % block_a->hash ().to_string () % account_a.to_account ());
+    error = true;
+  }
+  if (!error && generate_work_a)
+  {
+    work_ensure (account_a, block_a->hash ());
+  }
+  return error;
+}
+
 void chratos::wallet::work_ensure (chratos::account const & account_a, chratos::block_hash const & hash_a)
 {
   auto this_l (shared_from_this ());
@@ -1395,45 +1341,44 @@ bool chratos::wallet::search_pending ()
   return result;
 }
 
-std::vector<chratos::dividend_claim_result> chratos::wallet::claim_dividends ()
+std::vector<chratos::dividend_claim_result> chratos::wallet::claim_dividends_action ()
 {
   std::vector<chratos::dividend_claim_result> result;
-  chratos::transaction transaction (store.environment, nullptr, false);
-  auto dividend_order (node.ledger.get_dividend_indexes (transaction));
-  const size_t size = dividend_order.size ();
-  std::vector<chratos::block_hash> ordered (size);
-  ordered.reserve (size);
-  
-  std::fill(ordered.begin(), ordered.end(), 0);
-
-  for (auto & it : dividend_order)
+  std::vector<chratos::account> accounts;
+  chratos::account representative;
   {
-    ordered[it.second] = it.first;
+    chratos::transaction transaction (store.environment, nullptr, false);
+    representative = store.representative (transaction);
+    for (auto i (store.begin (transaction)), n (store.end ()); i != n; ++i)
+    {
+      if (!chratos::wallet_value (i->second).key.is_zero ())
+      {
+        accounts.push_back (chratos::account (i->first));
+      }
+    }
   }
-
-  chratos::account representative (store.representative (transaction));
-
-  for (auto & hash : ordered)
+  // Each account catches up in one chain instead of a receive and claim round trip per dividend
+  for (auto & account : accounts)
   {
-    auto accounts = search_unclaimed (hash);
-    std::shared_ptr<chratos::block> dividend_l (node.store.block_get(transaction, hash));
-    for (auto & account : accounts)
+    for (auto & block : claim_chain_action (account, representative, 0))
     {
-      // Check pending and claim outstanding
-      receive_outstanding_pendings_sync (transaction, account, hash);
-      // Check dividend points to the account's last claimed
-      chratos::account_info info;
-      node.store.account_get (transaction, account, info);
-      // Claim dividends
-      auto claim_hash = claim_dividend_sync (dividend_l, account, representative);
-
-      result.push_back (chratos::dividend_claim_result (account, hash, claim_hash));
+      if (block->type () == chratos::block_type::claim)
+      {
+        result.push_back (chratos::dividend_claim_result (account, block->dividend (), block->hash ()));
+      }
     }
   }
 
   return result;
 }
 
+void chratos::wallet::claim_dividends_async (std::function<void(std::vector<chratos::dividend_claim_result>)> const & action_a)
+{
+  node.wallets.queue_wallet_action (chratos::wallets::high_priority, [this, action_a]() {
+    action_a (claim_dividends_action ());
+  });
+}
+
 std::vector<chratos::block_hash> chratos::wallet::unclaimed_for_account (chratos::account const & account_a)
 {
   chratos::transaction transaction (store.environment, nullptr, false);
@@ -1509,59 +1454,253 @@ bool chratos::wallet::has_outstanding_pendings_for_dividend (MDB_txn * transacti
   return result;
 }
 
-void chratos::wallet::receive_outstanding_pendings_sync (MDB_txn * transaction_a, chratos::account const & account_a, chratos::block_hash const & dividend_a)
+std::vector<std::shared_ptr<chratos::block>> chratos::wallet::receive_chain_action (chratos::account const & account_a, std::vector<chratos::block_hash> const & sends_a, chratos::account const & representative_a, bool generate_work_a)
 {
-  const auto div_block = node.ledger.store.block_get (transaction_a, dividend_a);
-  const auto last_dividend_hash = div_block->dividend ();
-
-  chratos::account representative;
-
-  representative = store.representative (transaction_a);
+  std::vector<std::shared_ptr<chratos::block>> result;
+  std::unique_ptr<chratos::chain_builder> builder;
+  {
+    chratos::transaction transaction (store.environment, nullptr, false);
+    builder.reset (new chratos::chain_builder (*this, transaction, account_a));
+    for (auto i (sends_a.begin ()), n (sends_a.end ()); i != n && !builder->error; ++i)
+    {
+      if (builder->receive (transaction, *i, representative_a))
+      {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Not receiving block %1% in chain for %2%") % i->to_string () % account_a.to_account ());
+      }
+    }
+  }
+  if (!builder->error)
+  {
+    result = builder->submit (generate_work_a);
+  }
+  return result;
+}
 
-  for (auto j (node.store.pending_begin (transaction_a, chratos::pending_key (account_a, 0))), m (node.store.pending_begin (transaction_a, chratos::pending_key (account_a.number () + 1, 0))); j != m; ++j)
+std::vector<std::shared_ptr<chratos::block>> chratos::wallet::send_chain_action (chratos::account const & source_a, std::vector<std::pair<chratos::account, chratos::uint128_t>> const & destinations_a, bool generate_work_a)
+{
+  std::vector<std::shared_ptr<chratos::block>> result;
+  std::unique_ptr<chratos::chain_builder> builder;
   {
-    chratos::pending_key key (j->first);
-    chratos::pending_info pending (j->second);
-    if (pending.dividend == last_dividend_hash)
+    chratos::transaction transaction (store.environment, nullptr, false);
+    builder.reset (new chratos::chain_builder (*this, transaction, source_a));
+    // Nothing is sent unless the balance covers every destination
+    for (auto i (destinations_a.begin ()), n (destinations_a.end ()); i != n && !builder->error; ++i)
     {
-      auto hash (key.hash);
-      auto amount (pending.amount.number ());
-      std::shared_ptr<chratos::block> block = node.store.block_get (transaction_a, hash);
-      receive_sync (block, representative, amount, true);
+      if (builder->send (transaction, i->first, i->second))
+      {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Not sending chain from %1%, balance doesn't cover the send to %2%") % source_a.to_account () % i->first.to_account ());
+        builder->error = true;
+      }
     }
   }
+  if (!builder->error)
+  {
+    result = builder->submit (generate_work_a);
+  }
+  return result;
 }
 
-void chratos::wallet::receive_outstanding_pendings_async (MDB_txn * transaction_a, chratos::account const & account_a, chratos::block_hash const & dividend_a, std::function<void()> const & action_a, bool generate_work_a)
+std::vector<std::shared_ptr<chratos::block>> chratos::wallet::claim_chain_action (chratos::account const & account_a, chratos::account const & representative_a, chratos::block_hash const & last_a, bool generate_work_a)
 {
-  const auto div_block = node.ledger.store.block_get (transaction_a, dividend_a);
-  const auto last_dividend_hash = div_block->dividend ();
+  std::vector<std::shared_ptr<chratos::block>> result;
+  std::unique_ptr<chratos::chain_builder> builder;
+  {
+    chratos::transaction transaction (store.environment, nullptr, false);
+    builder.reset (new chratos::chain_builder (*this, transaction, account_a));
+    auto dividends (node.ledger.unclaimed_for_account (transaction, account_a));
+    auto done (builder->error);
+    for (auto i (dividends.begin ()), n (dividends.end ()); i != n && !done; ++i)
+    {
+      // Each claim needs everything sent under the account's current dividend received ahead of it
+      std::vector<chratos::block_hash> sends;
+      for (auto j (node.store.pending_begin (transaction, chratos::pending_key (account_a, 0))), m (node.store.pending_begin (transaction, chratos::pending_key (account_a.number () + 1, 0))); j != m; ++j)
+      {
+        chratos::pending_key key (j->first);
+        chratos::pending_info pending (j->second);
+        if (pending.dividend == builder->dividend)
+        {
+          sends.push_back (key.hash);
+        }
+      }
+      for (auto j (sends.begin ()), m (sends.end ()); j != m && !done; ++j)
+      {
+        done = builder->receive (transaction, *j, representative_a);
+      }
+      if (!done && builder->claim (transaction, *i))
+      {
+        BOOST_LOG (node.log) << boost::str (boost::format ("Not claiming dividend %1% in chain for %2%") % i->to_string () % account_a.to_account ());
+        done = true;
+      }
+      done = done || *i == last_a;
+    }
+  }
+  if (!builder->error)
+  {
+    result = builder->submit (generate_work_a);
+  }
+  return result;
+}
 
-  chratos::account representative;
-  representative = store.representative (transaction_a);
+void chratos::wallet::claim_chain_async (chratos::account const & account_a, chratos::account const & representative_a, chratos::block_hash const & last_a, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const & action_a, bool generate_work_a)
+{
+  node.wallets.queue_wallet_action (chratos::wallets::high_priority, [this, account_a, representative_a, last_a, action_a, generate_work_a]() {
+    auto blocks (claim_chain_action (account_a, representative_a, last_a, generate_work_a));
+    action_a (blocks);
+  });
+}
 
-  auto pending (node.store.pending_begin (transaction_a, chratos::pending_key (account_a, 0)));
+void chratos::wallet::receive_chain_async (chratos::account const & account_a, std::vector<chratos::block_hash> const & sends_a, chratos::account const & representative_a, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const & action_a, bool generate_work_a)
+{
+  node.wallets.queue_wallet_action (chratos::wallets::high_priority, [this, account_a, sends_a, representative_a, action_a, generate_work_a]() {
+    auto blocks (receive_chain_action (account_a, sends_a, representative_a, generate_work_a));
+    action_a (blocks);
+  });
+}
 
-  auto end (node.store.pending_begin (transaction_a, chratos::pending_key (account_a.number () + 1, 0)));
+void chratos::wallet::send_chain_async (chratos::account const & source_a, std::vector<std::pair<chratos::account, chratos::uint128_t>> const & destinations_a, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const & action_a, bool generate_work_a)
+{
+  node.wallets.queue_wallet_action (chratos::wallets::high_priority, [this, source_a, destinations_a, action_a, generate_work_a]() {
+    auto blocks (send_chain_action (source_a, destinations_a, generate_work_a));
+    action_a (blocks);
+  });
+}
 
-  std::function<void(chratos::store_iterator<chratos::pending_key, chratos::pending_info> &)> check_and_claim;
+chratos::chain_builder::chain_builder (chratos::wallet & wallet_a, MDB_txn * transaction_a, chratos::account const & account_a) :
+wallet (wallet_a),
+account (account_a),
+error (false),
+head (0),
+balance (0),
+representative (0),
+dividend (0),
+cached_work (0),
+sends (false)
+{
+  error = !wallet.store.valid_password (transaction_a) || wallet.store.fetch (transaction_a, account, prv);
+  if (!error)
+  {
+    wallet.store.work_get (transaction_a, account, cached_work);
+    dividend_head = wallet.node.store.dividend_get (transaction_a).head;
+    chratos::account_info info;
+    if (!wallet.node.store.account_get (transaction_a, account, info))
+    {
+      auto rep_block (wallet.node.store.block_get (transaction_a, info.rep_block));
+      assert (rep_block != nullptr);
+      head = info.head;
+      balance = info.balance;
+      representative = rep_block->representative ();
+      dividend = info.dividend_block;
+    }
+  }
+}
 
-  check_and_claim = [this, &transaction_a, &end, last_dividend_hash, &check_and_claim, action_a, representative] (chratos::store_iterator<chratos::pending_key, chratos::pending_info> & current) {
-    if (current == end) {
-      return action_a ();
+bool chratos::chain_builder::receive (MDB_txn * transaction_a, chratos::block_hash const & send_a, chratos::account const & representative_a)
+{
+  chratos::pending_info pending;
+  auto result (wallet.node.store.pending_get (transaction_a, chratos::pending_key (account, send_a), pending));
+  if (!result)
+  {
+    if (head.is_zero ())
+    {
+      representative = representative_a;
+      dividend = pending.dividend;
     }
-    chratos::pending_key key (current->first);
-    chratos::pending_info pending (current->second);
-    if (pending.dividend == last_dividend_hash)
+    // As with a single receive, the account's dividend must be at or after the one the send was made under
+    else if (pending.dividend != dividend && !wallet.node.ledger.dividends_are_ordered (transaction_a, pending.dividend, dividend))
     {
-      auto hash (key.hash);
-      auto amount (pending.amount.number ());
-      std::shared_ptr<chratos::block> block = node.store.block_get (transaction_a, hash);
-      receive_async (block, representative, amount, [&check_and_claim, &current](std::shared_ptr<chratos::block> b) {
-        check_and_claim (++current);
-      }, true);
+      result = true;
     }
-  };
+    if (!result)
+    {
+      balance = balance.number () + pending.amount.number ();
+      received.insert (send_a);
+      append (std::make_shared<chratos::state_block> (account, head, representative, balance, send_a, pending.dividend, 0));
+    }
+  }
+  return result;
+}
+
+bool chratos::chain_builder::send (MDB_txn * transaction_a, chratos::account const & destination_a, chratos::uint128_t const & amount_a)
+{
+  auto result (head.is_zero () || balance.number () < amount_a);
+  if (!result)
+  {
+    balance = balance.number () - amount_a;
+    sends = true;
+    append (std::make_shared<chratos::state_block> (account, head, representative, balance, destination_a, dividend_head, 0));
+  }
+  return result;
+}
+
+bool chratos::chain_builder::claim (MDB_txn * transaction_a, chratos::block_hash const & dividend_a)
+{
+  auto dividend_block (wallet.node.store.block_get (transaction_a, dividend_a));
+  // Sends are made under the latest dividend so nothing is left to claim after one
+  auto result (head.is_zero () || sends || dividend_block == nullptr || dividend_block->type () != chratos::block_type::dividend || dividend_block->dividend () != dividend);
+  for (auto i (wallet.node.store.pending_begin (transaction_a, chratos::pending_key (account, 0))), n (wallet.node.store.pending_begin (transaction_a, chratos::pending_key (account.number () + 1, 0))); i != n && !result; ++i)
+  {
+    chratos::pending_key key (i->first);
+    chratos::pending_info pending (i->second);
+    result = pending.dividend == dividend && received.find (key.hash) == received.end ();
+  }
+  if (!result)
+  {
+    // Until the chain has a block of its own the balance at the dividend comes from the ledger, after that every block in it precedes the dividend
+    auto amount (blocks.empty () ? wallet.node.ledger.amount_for_dividend (transaction_a, dividend_a, account) : wallet.node.ledger.dividend_reward (transaction_a, dividend_a, balance));
+    balance = balance.number () + amount.number ();
+    dividend = dividend_a;
+    append (std::make_shared<chratos::claim_block> (account, head, representative, balance, dividend_a, 0));
+  }
+  return result;
+}
+
+void chratos::chain_builder::append (std::shared_ptr<chratos::block> block_a)
+{
+  auto root (block_a->root ());
+  auto promise (std::make_shared<std::promise<uint64_t>> ());
+  work.push_back (promise->get_future ());
+  if (blocks.empty () && !chratos::work_validate (root, cached_work))
+  {
+    promise->set_value (cached_work);
+  }
+  else
+  {
+    wallet.node.work_generate (root, [promise](uint64_t work_a) {
+      promise->set_value (work_a);
+    });
+  }
+  head = block_a->hash ();
+  hashes.push_back (head);
+  blocks.push_back (block_a);
+}
+
+std::vector<std::shared_ptr<chratos::block>> chratos::chain_builder::submit (bool generate_work_a)
+{
+  std::vector<std::shared_ptr<chratos::block>> result;
+  // Blocks are built unsigned, the whole chain is signed with one expansion of the key while work is still generating
+  std::vector<chratos::signature> signatures (hashes.size ());
+  chratos::sign_message_batch (prv, account, hashes.data (), hashes.size (), signatures.data ());
+  for (size_t i (0), n (blocks.size ()); i < n; ++i)
+  {
+    blocks[i]->signature_set (signatures[i]);
+    blocks[i]->block_work_set (work[i].get ());
+  }
+  std::vector<chratos::process_return> processed;
+  wallet.node.process_local (blocks, processed);
+  // Every block builds on the one before, the chain is only as good as its first rejected block
+  for (size_t i (0), n (processed.size ()); i < n && processed[i].code == chratos::process_result::progress; ++i)
+  {
+    result.push_back (blocks[i]);
+  }
+  if (result.size () < blocks.size ())
+  {
+    BOOST_LOG (wallet.node.log) << boost::str (boost::format ("Only %1% of %2% chained blocks for account %3% were accepted by the ledger") % result.size () % blocks.size () % account.to_account ());
+  }
+  if (generate_work_a && !result.empty ())
+  {
+    wallet.work_ensure (account, result.back ()->hash ());
+  }
+  return result;
 }
 
 void chratos::wallet::init_free_accounts (MDB_txn * transaction_a)
@@ -1632,8 +1771,10 @@ chratos::wallets::wallets (bool & error_a, chratos::node & node_a) :
 observer ([](bool) {}),
 node (node_a),
 stopped (false),
+initial_unlock_done (true),
 thread ([this]() { do_wallet_actions (); })
 {
+  node.startup.phase ("store_and_network");
   if (!error_a)
   {
     chratos::transaction transaction (node.store.environment, nullptr, true);
@@ -1641,6 +1782,7 @@ thread ([this]() { do_wallet_actions (); })
     status |= mdb_dbi_open (transaction, "send_action_ids", MDB_CREATE, &send_action_ids);
     status |= mdb_dbi_open (transaction, "pay_dividend_action_ids", MDB_CREATE, &pay_dividend_action_ids);
     assert (status == 0);
+    send_ids.load (transaction, send_action_ids);
     std::string beginning (chratos::uint256_union (0).to_string ());
     std::string end ((chratos::uint256_union (chratos::uint256_t (0) - chratos::uint256_t (1))).to_string ());
     chratos::store_iterator<std::array<char, 64>, chratos::mdb_val::no_value> i (std::make_unique<chratos::mdb_iterator<std::array<char, 64>, chratos::mdb_val::no_value>> (transaction, handle, chratos::mdb_val (beginning.size (), const_cast<char *> (beginning.c_str ()))));
@@ -1663,10 +1805,139 @@ thread ([this]() { do_wallet_actions (); })
       }
     }
   }
-  for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
+  node.startup.phase ("wallet_load");
+}
+
+void chratos::send_id_index::load (MDB_txn * transaction_a, MDB_dbi table_a)
+{
+  auto now (chratos::seconds_since_epoch ());
+  std::lock_guard<std::mutex> lock (mutex);
+  ids.clear ();
+  by_seen.clear ();
+  MDB_cursor * cursor;
+  auto status (mdb_cursor_open (transaction_a, table_a, &cursor));
+  assert (status == 0);
+  MDB_val key;
+  MDB_val value;
+  for (auto status2 (mdb_cursor_get (cursor, &key, &value, MDB_FIRST)); status2 == 0; status2 = mdb_cursor_get (cursor, &key, &value, MDB_NEXT))
+  {
+    chratos::block_hash hash;
+    uint64_t seen (now);
+    assert (value.mv_size >= sizeof (hash));
+    std::copy (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (hash), hash.bytes.begin ());
+    if (value.mv_size >= sizeof (hash) + sizeof (seen))
+    {
+      std::copy (reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (hash), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (hash) + sizeof (seen), reinterpret_cast<uint8_t *> (&seen));
+      boost::endian::big_to_native_inplace (seen);
+    }
+    else
+    {
+      // Entries written before the timestamp was stored count from the first load after upgrading, store that so later loads keep it
+      std::vector<uint8_t> upgraded;
+      {
+        chratos::vectorstream stream (upgraded);
+        chratos::write (stream, hash);
+        chratos::write (stream, boost::endian::native_to_big (seen));
+      }
+      MDB_val upgraded_value{ upgraded.size (), upgraded.data () };
+      auto status3 (mdb_cursor_put (cursor, &key, &upgraded_value, MDB_CURRENT));
+      assert (status3 == 0);
+    }
+    std::string id (reinterpret_cast<char const *> (key.mv_data), key.mv_size);
+    by_seen.insert (std::make_pair (seen, id));
+    ids[id] = std::make_pair (hash, seen);
+  }
+  mdb_cursor_close (cursor);
+}
+
+boost::optional<chratos::block_hash> chratos::send_id_index::find (std::string const & id_a)
+{
+  boost::optional<chratos::block_hash> result;
+  std::lock_guard<std::mutex> lock (mutex);
+  auto existing (ids.find (id_a));
+  if (existing != ids.end ())
   {
-    i->second->enter_initial_password ();
+    result = existing->second.first;
   }
+  return result;
+}
+
+bool chratos::send_id_index::put (MDB_txn * transaction_a, MDB_dbi table_a, std::string const & id_a, chratos::block_hash const & hash_a)
+{
+  auto seen (chratos::seconds_since_epoch ());
+  std::vector<uint8_t> value;
+  {
+    chratos::vectorstream stream (value);
+    chratos::write (stream, hash_a);
+    chratos::write (stream, boost::endian::native_to_big (seen));
+  }
+  auto status (mdb_put (transaction_a, table_a, chratos::mdb_val (id_a.size (), const_cast<char *> (id_a.data ())), chratos::mdb_val (value.size (), value.data ()), 0));
+  auto result (status != 0);
+  if (!result)
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    auto existing (ids.find (id_a));
+    if (existing != ids.end ())
+    {
+      by_seen.erase (std::make_pair (existing->second.second, id_a));
+    }
+    by_seen.insert (std::make_pair (seen, id_a));
+    ids[id_a] = std::make_pair (hash_a, seen);
+  }
+  return result;
+}
+
+std::vector<std::string> chratos::send_id_index::expired (uint64_t cutoff_a, size_t max_a)
+{
+  std::vector<std::string> result;
+  std::lock_guard<std::mutex> lock (mutex);
+  for (auto i (by_seen.begin ()), n (by_seen.end ()); i != n && i->first < cutoff_a && result.size () < max_a; ++i)
+  {
+    result.push_back (i->second);
+  }
+  return result;
+}
+
+void chratos::send_id_index::erase (MDB_txn * transaction_a, MDB_dbi table_a, std::vector<std::string> const & ids_a)
+{
+  for (auto & i : ids_a)
+  {
+    auto status (mdb_del (transaction_a, table_a, chratos::mdb_val (i.size (), const_cast<char *> (i.data ())), nullptr));
+    assert (status == 0 || status == MDB_NOTFOUND);
+  }
+  std::lock_guard<std::mutex> lock (mutex);
+  for (auto & i : ids_a)
+  {
+    auto existing (ids.find (i));
+    if (existing != ids.end ())
+    {
+      by_seen.erase (std::make_pair (existing->second.second, i));
+      ids.erase (existing);
+    }
+  }
+}
+
+size_t chratos::send_id_index::size ()
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return ids.size ();
+}
+
+size_t chratos::wallets::expire_send_ids ()
+{
+  size_t result (0);
+  if (node.config.send_id_retention != 0)
+  {
+    auto cutoff (chratos::seconds_since_epoch () - std::min<uint64_t> (chratos::seconds_since_epoch (), node.config.send_id_retention * 3600));
+    // Short write transactions so sends aren't held up behind a large expiry
+    for (auto expired (send_ids.expired (cutoff, 1024)); !expired.empty (); expired = send_ids.expired (cutoff, 1024))
+    {
+      chratos::transaction transaction (node.store.environment, nullptr, true);
+      send_ids.erase (transaction, send_action_ids, expired);
+      result += expired.size ();
+    }
+  }
+  return result;
 }
 
 chratos::wallets::~wallets ()
@@ -1739,27 +2010,76 @@ std::vector<chratos::account> chratos::wallets::search_unclaimed (chratos::block
 std::unordered_map<chratos::block_hash, std::vector<chratos::account>> chratos::wallets::search_unclaimed_all ()
 {
   std::unordered_map<chratos::block_hash, std::vector<chratos::account>> result;
+  unclaimed_foreach ([&result](chratos::account const & account_a, std::vector<chratos::block_hash> const & dividends_a) {
+    for (auto & i : dividends_a)
+    {
+      result[i].push_back (account_a);
+    }
+  });
+  return result;
+}
 
+void chratos::wallets::unclaimed_foreach (std::function<void(chratos::account const &, std::vector<chratos::block_hash> const &)> const & action_a)
+{
+  // Walk the dividend chain once, newest first, so each account only needs the position of its last claim
   std::vector<chratos::block_hash> dividends;
-
-  chratos::transaction transaction (node.store.environment, nullptr, true);
-  chratos::dividend_info div_info (node.store.dividend_get (transaction));
-  chratos::block_hash current_dividend (div_info.head);
-
-  while (current_dividend != chratos::uint256_union (0))
+  std::unordered_map<chratos::block_hash, size_t> positions;
+  std::vector<chratos::account> accounts;
   {
-    dividends.push_back(current_dividend);
-    auto block = node.store.block_get (transaction, current_dividend);
-    current_dividend = block->dividend ();
+    chratos::transaction transaction (node.store.environment, nullptr, false);
+    chratos::block_hash current (node.store.dividend_get (transaction).head);
+    while (!current.is_zero ())
+    {
+      positions[current] = dividends.size ();
+      dividends.push_back (current);
+      auto block (node.store.block_get (transaction, current));
+      current = block->dividend ();
+    }
+    for (auto & i : items)
+    {
+      if (i.second->store.valid_password (transaction))
+      {
+        for (auto j (i.second->store.begin (transaction)), m (i.second->store.end ()); j != m; ++j)
+        {
+          if (!chratos::wallet_value (j->second).key.is_zero ())
+          {
+            accounts.push_back (chratos::account (j->first));
+          }
+        }
+      }
+    }
   }
-
-  for (auto & dividend_hash : dividends)
+  std::mutex action_mutex;
+  auto search = [this, &dividends, &positions, &accounts, &action_mutex, &action_a](size_t begin_a, size_t end_a) {
+    chratos::transaction transaction (node.store.environment, nullptr, false);
+    for (auto i (begin_a); i < end_a; ++i)
+    {
+      chratos::account_info info;
+      if (!node.store.account_get (transaction, accounts[i], info))
+      {
+        auto existing (positions.find (info.dividend_block));
+        auto claimed (existing != positions.end () ? existing->second : dividends.size ());
+        std::vector<chratos::block_hash> unclaimed (dividends.rend () - claimed, dividends.rend ());
+        if (!unclaimed.empty ())
+        {
+          std::lock_guard<std::mutex> lock (action_mutex);
+          action_a (accounts[i], unclaimed);
+        }
+      }
+    }
+  };
+  auto thread_count (std::max<size_t> (1, std::min<size_t> (std::thread::hardware_concurrency (), accounts.size () / unclaimed_accounts_per_thread)));
+  auto per_thread ((accounts.size () + thread_count - 1) / thread_count);
+  std::vector<std::thread> threads;
+  for (size_t i (1); i < thread_count; ++i)
   {
-    auto unclaimed = search_unclaimed (dividend_hash);
-    result[dividend_hash] = unclaimed;
+    threads.push_back (std::thread (search, std::min (i * per_thread, accounts.size ()), std::min ((i + 1) * per_thread, accounts.size ())));
+  }
+  search (0, std::min (per_thread, accounts.size ()));
+  for (auto & i : threads)
+  {
+    i.join ();
   }
-
-  return result;
 }
 
 void chratos::wallets::destroy (chratos::uint256_union const & id_a)
@@ -1802,9 +2122,43 @@ void chratos::wallets::queue_wallet_action (chratos::uint128_t const & amount_a,
   condition.notify_all ();
 }
 
-void chratos::wallets::foreach_representative (MDB_txn * transaction_a, std::function<void(chratos::public_key const & pub_a, chratos::raw_key const & prv_a)> const & action_a)
+void chratos::wallets::enter_initial_passwords ()
 {
+  std::vector<std::shared_ptr<chratos::wallet>> wallets_l;
   for (auto i (items.begin ()), n (items.end ()); i != n; ++i)
+  {
+    wallets_l.push_back (i->second);
+  }
+  auto begin (std::chrono::steady_clock::now ());
+  initial_unlock_done = false;
+  // Ahead of any queued sends, they would only fail against a locked wallet
+  queue_wallet_action (std::numeric_limits<chratos::uint128_t>::max (), [this, wallets_l, begin]() {
+    for (auto i (wallets_l.begin ()), n (wallets_l.end ()); i != n; ++i)
+    {
+      (*i)->enter_initial_password ();
+    }
+    initial_unlock_done = true;
+    node.startup.record ("wallet_unlock", begin);
+    auto keys_begin (std::chrono::steady_clock::now ());
+    {
+      // Fetching each representative key fills the expanded key cache so the first votes skip key expansion
+      chratos::transaction transaction (node.store.environment, nullptr, false);
+      foreach_representative (transaction, [](chratos::public_key const &, chratos::expanded_key const &) {});
+    }
+    node.startup.record ("representative_keys", keys_begin);
+  });
+}
+
+size_t chratos::wallets::actions_size ()
+{
+  std::lock_guard<std::mutex> lock (mutex);
+  return actions.size ();
+}
+
+void chratos::wallets::foreach_representative (MDB_txn * transaction_a, std::function<void(chratos::public_key const & pub_a, chratos::expanded_key const & prv_a)> const & action_a)
+{
+  // No representative is ready to vote before the startup unlock has finished, see enter_initial_passwords
+  for (auto i (items.begin ()), n (items.end ()); initial_unlock_done && i != n; ++i)
   {
     auto & wallet (*i->second);
     for (auto j (wallet.store.begin (transaction_a)), m (wallet.store.end ()); j != m; ++j)
@@ -1814,7 +2168,7 @@ void chratos::wallets::foreach_representative (MDB_txn * transaction_a, std::fun
       {
         if (wallet.store.valid_password (transaction_a))
         {
-          chratos::raw_key prv;
+          chratos::expanded_key prv;
           auto error (wallet.store.fetch (transaction_a, chratos::uint256_union (j->first), prv));
           assert (!error);
           action_a (chratos::uint256_union (j->first), prv);
@@ -1858,6 +2212,7 @@ void chratos::wallets::stop ()
 
 chratos::uint128_t const chratos::wallets::generate_priority = std::numeric_limits<chratos::uint128_t>::max ();
 chratos::uint128_t const chratos::wallets::high_priority = std::numeric_limits<chratos::uint128_t>::max () - 1;
+size_t constexpr chratos::wallets::unclaimed_accounts_per_thread;
 
 chratos::store_iterator<chratos::uint256_union, chratos::wallet_value> chratos::wallet_store::begin (MDB_txn * transaction_a)
 {
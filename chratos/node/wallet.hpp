@@ -5,8 +5,11 @@
 #include <chratos/secure/blockstore.hpp>
 #include <chratos/secure/common.hpp>
 
+#include <atomic>
+#include <future>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <thread>
 #include <unordered_set>
 
@@ -88,6 +91,10 @@ public:
 	chratos::wallet_value entry_get_raw (MDB_txn *, chratos::public_key const &);
 	void entry_put_raw (MDB_txn *, chratos::public_key const &, chratos::wallet_value const &);
 	bool fetch (MDB_txn *, chratos::public_key const &, chratos::raw_key &);
+	// Signing key for pub, expanded once per unlock and kept until the wallet is locked
+	bool fetch (MDB_txn *, chratos::public_key const &, chratos::expanded_key &);
+	// Forget the password and clear every cached signing key
+	void lock ();
 	bool exists (MDB_txn *, chratos::public_key const &);
 	void destroy (MDB_txn *);
 	chratos::store_iterator<chratos::uint256_union, chratos::wallet_value> find (MDB_txn *, chratos::uint256_union const &);
@@ -130,6 +137,9 @@ public:
 	chratos::mdb_env & environment;
 	MDB_dbi handle;
 	std::recursive_mutex mutex;
+
+private:
+	std::unordered_map<chratos::public_key, chratos::expanded_key> expanded_keys;
 };
 class node;
 // A wallet is a set of account keys encrypted by a common encryption key
@@ -140,7 +150,6 @@ public:
 	std::shared_ptr<chratos::block> receive_action (chratos::block const &, chratos::account const &, chratos::uint128_union const &, bool = true, bool = false);
 	std::shared_ptr<chratos::block> send_action (chratos::account const &, chratos::account const &, chratos::uint128_t const &, bool = true, boost::optional<std::string> = {});
   std::shared_ptr<chratos::block> pay_dividend_action (chratos::account const &, chratos::uint128_t const &, bool = true, boost::optional<std::string> = {});
-  std::shared_ptr<chratos::block> claim_dividend_action (chratos::block const &, chratos::account const &, chratos::account const &, bool = true);
 	wallet (bool &, chratos::transaction &, chratos::node &, std::string const &);
 	wallet (bool &, chratos::transaction &, chratos::node &, std::string const &, std::string const &);
 	void enter_initial_password ();
@@ -162,20 +171,27 @@ public:
 	void send_async (chratos::account const &, chratos::account const &, chratos::uint128_t const &, std::function<void(std::shared_ptr<chratos::block>)> const &, bool = true, boost::optional<std::string> = {});
 	chratos::block_hash send_dividend_sync (chratos::account const &, chratos::uint128_t const &);
   void send_dividend_async (chratos::account const &, chratos::uint128_t const &, std::function<void(std::shared_ptr<chratos::block>)> const &, bool = true, boost::optional<std::string> = {});
-  chratos::block_hash claim_dividend_sync (std::shared_ptr<chratos::block>, chratos::account const &, chratos::account const &);
-  void claim_dividend_async (std::shared_ptr<chratos::block>, chratos::account const &, chratos::account const &, std::function<void(std::shared_ptr<chratos::block>)> const &, bool = true);
 	void work_apply (chratos::account const &, std::function<void(uint64_t)>);
 	void work_cache_blocking (chratos::account const &, chratos::block_hash const &);
 	void work_update (MDB_txn *, chratos::account const &, chratos::block_hash const &, uint64_t);
 	void work_ensure (chratos::account const &, chratos::block_hash const &);
+	// Generate work if needed and process a block built by an action, returns true if the ledger didn't accept it
+	bool action_process (std::shared_ptr<chratos::block> const &, chratos::account const &, bool);
 	bool search_pending ();
-  std::vector<chratos::dividend_claim_result> claim_dividends ();
+  // Claim every unclaimed dividend for each account in the wallet, only call on the wallet action thread
+  std::vector<chratos::dividend_claim_result> claim_dividends_action ();
+  void claim_dividends_async (std::function<void(std::vector<chratos::dividend_claim_result>)> const &);
   std::vector<chratos::block_hash> unclaimed_for_account (chratos::account const &);
   std::vector<chratos::account> search_unclaimed (chratos::block_hash const &);
   chratos::amount amount_for_dividend (MDB_txn *, std::shared_ptr<chratos::block>, chratos::account const &);
   bool has_outstanding_pendings_for_dividend (MDB_txn *, std::shared_ptr<chratos::block>, chratos::account const &);
-  void receive_outstanding_pendings_sync (MDB_txn *, chratos::account const &, chratos::block_hash const &);
-  void receive_outstanding_pendings_async (MDB_txn *, chratos::account const &, chratos::block_hash const &, std::function<void()> const &, bool = true);
+	std::vector<std::shared_ptr<chratos::block>> receive_chain_action (chratos::account const &, std::vector<chratos::block_hash> const &, chratos::account const &, bool = true);
+	std::vector<std::shared_ptr<chratos::block>> send_chain_action (chratos::account const &, std::vector<std::pair<chratos::account, chratos::uint128_t>> const &, bool = true);
+	void receive_chain_async (chratos::account const &, std::vector<chratos::block_hash> const &, chratos::account const &, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const &, bool = true);
+	void send_chain_async (chratos::account const &, std::vector<std::pair<chratos::account, chratos::uint128_t>> const &, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const &, bool = true);
+	// Receive and claim in dividend order up to and including last_a, or every unclaimed dividend if it's zero
+	std::vector<std::shared_ptr<chratos::block>> claim_chain_action (chratos::account const &, chratos::account const &, chratos::block_hash const &, bool = true);
+	void claim_chain_async (chratos::account const &, chratos::account const &, chratos::block_hash const &, std::function<void(std::vector<std::shared_ptr<chratos::block>>)> const &, bool = true);
 	void init_free_accounts (MDB_txn *);
 	/** Changes the wallet seed and returns the first account */
 	chratos::public_key change_seed (MDB_txn * transaction_a, chratos::raw_key const & prv_a);
@@ -184,6 +200,63 @@ public:
 	chratos::wallet_store store;
 	chratos::node & node;
 };
+/**
+ * Builds consecutive blocks for one account in memory from a single read of its state.
+ * Work for each block starts as soon as its predecessor is hashed, the chain is signed and processed as one batch.
+ */
+class chain_builder
+{
+public:
+	chain_builder (chratos::wallet &, MDB_txn *, chratos::account const &);
+	// Append a receive of the pending send_a, returns true if it can't be received
+	bool receive (MDB_txn *, chratos::block_hash const &, chratos::account const &);
+	// Append a send to the destination, returns true if the balance doesn't cover it
+	bool send (MDB_txn *, chratos::account const &, chratos::uint128_t const &);
+	// Append a claim of dividend_a, returns true if it isn't the next dividend or sends made under the previous one are still pending
+	bool claim (MDB_txn *, chratos::block_hash const &);
+	// Wait for the chain's work and process it, returning the blocks that were added to the ledger
+	std::vector<std::shared_ptr<chratos::block>> submit (bool);
+	chratos::wallet & wallet;
+	chratos::account account;
+	bool error;
+	chratos::expanded_key prv;
+	chratos::block_hash head;
+	chratos::amount balance;
+	chratos::account representative;
+	// Last dividend the account has claimed, including claims earlier in this chain
+	chratos::block_hash dividend;
+	chratos::block_hash dividend_head;
+	uint64_t cached_work;
+	bool sends;
+	std::unordered_set<chratos::block_hash> received;
+	std::vector<std::shared_ptr<chratos::block>> blocks;
+	std::vector<chratos::block_hash> hashes;
+	std::vector<std::future<uint64_t>> work;
+
+private:
+	void append (std::shared_ptr<chratos::block>);
+};
+/**
+ * In-memory copy of the send_action_ids table so a repeated send ID is answered without a write transaction.
+ * Entries are the block hash and the time the ID was first seen.
+ */
+class send_id_index
+{
+public:
+	// Rows written before timestamps were stored are stamped with the load time and rewritten, requires a write transaction
+	void load (MDB_txn *, MDB_dbi);
+	boost::optional<chratos::block_hash> find (std::string const &);
+	// Record a new ID in the table and the index, returns true on error
+	bool put (MDB_txn *, MDB_dbi, std::string const &, chratos::block_hash const &);
+	// At most max_a IDs first seen before cutoff_a
+	std::vector<std::string> expired (uint64_t cutoff_a, size_t max_a);
+	void erase (MDB_txn *, MDB_dbi, std::vector<std::string> const &);
+	size_t size ();
+	std::mutex mutex;
+	std::unordered_map<std::string, std::pair<chratos::block_hash, uint64_t>> ids;
+	// The same IDs ordered by when they were first seen, oldest first
+	std::set<std::pair<uint64_t, std::string>> by_seen;
+};
 // The wallets set is all the wallets a node controls.  A node may contain multiple wallets independently encrypted and operated.
 class wallets
 {
@@ -196,11 +269,20 @@ public:
 	void search_pending_all ();
   std::vector<chratos::account> search_unclaimed (chratos::block_hash const &);
   std::unordered_map<chratos::block_hash, std::vector<chratos::account>> search_unclaimed_all ();
+	// Call the action with each unlocked wallet account's unclaimed dividends, oldest first, as soon as that account is done.
+	// Accounts are split across threads so the action is serialized but called from any of them.
+	void unclaimed_foreach (std::function<void(chratos::account const &, std::vector<chratos::block_hash> const &)> const &);
 	void destroy (chratos::uint256_union const &);
 	void do_wallet_actions ();
 	void queue_wallet_action (chratos::uint128_t const &, std::function<void()> const &);
-	void foreach_representative (MDB_txn *, std::function<void(chratos::public_key const &, chratos::raw_key const &)> const &);
+	// Unlock wallets that have an empty password and warm the representative key cache on the wallet action thread
+	// Until the unlock finishes representatives don't vote and wallet RPCs answer with a retryable error instead of wallet_locked
+	void enter_initial_passwords ();
+	size_t actions_size ();
+	void foreach_representative (MDB_txn *, std::function<void(chratos::public_key const &, chratos::expanded_key const &)> const &);
 	bool exists (MDB_txn *, chratos::public_key const &);
+	// Remove send IDs older than the configured retention, returns the number removed
+	size_t expire_send_ids ();
 	void stop ();
 	std::function<void(bool)> observer;
 	std::unordered_map<chratos::uint256_union, std::shared_ptr<chratos::wallet>> items;
@@ -210,11 +292,15 @@ public:
 	chratos::kdf kdf;
 	MDB_dbi handle;
 	MDB_dbi send_action_ids;
+	chratos::send_id_index send_ids;
   MDB_dbi pay_dividend_action_ids;
 	chratos::node & node;
 	bool stopped;
+	// False while enter_initial_passwords is still unlocking the wallets
+	std::atomic<bool> initial_unlock_done;
 	std::thread thread;
 	static chratos::uint128_t const generate_priority;
 	static chratos::uint128_t const high_priority;
+	static size_t constexpr unclaimed_accounts_per_thread = 256;
 };
 }
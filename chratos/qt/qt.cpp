@@ -274,6 +274,34 @@ void chratos_qt::accounts::refresh_wallet_balance ()
 	});
 }
 
+void chratos_qt::accounts::refresh_accounts (std::unordered_set<chratos::account> const & accounts_a)
+{
+	auto rebuild (false);
+	{
+		chratos::transaction transaction (wallet.wallet_m->store.environment, nullptr, false);
+		auto remaining (accounts_a);
+		for (int row (0), n (model->rowCount ()); row < n && !remaining.empty (); ++row)
+		{
+			chratos::account account;
+			if (!account.decode_account (model->item (row, 1)->text ().toStdString ()) && remaining.erase (account) != 0)
+			{
+				auto balance_amount (wallet.node.ledger.account_balance (transaction, account));
+				model->item (row, 0)->setText (QString (wallet.format_balance (balance_amount).c_str ()));
+				// Adhoc keys are only listed while they hold a balance
+				rebuild = rebuild || (balance_amount.is_zero () && wallet.wallet_m->store.key_type (wallet.wallet_m->store.entry_get_raw (transaction, account)) == chratos::key_type::adhoc);
+			}
+		}
+		for (auto i (remaining.begin ()), n (remaining.end ()); !rebuild && i != n; ++i)
+		{
+			rebuild = wallet.wallet_m->store.exists (transaction, *i);
+		}
+	}
+	if (rebuild)
+	{
+		refresh ();
+	}
+}
+
 void chratos_qt::accounts::refresh ()
 {
 	model->removeRows (0, model->rowCount ());
@@ -311,6 +339,11 @@ void chratos_qt::accounts::refresh ()
 	}
 }
 
+size_t constexpr chratos_qt::dividends::page_size;
+size_t constexpr chratos_qt::claims_viewer::page_size;
+size_t constexpr chratos_qt::claims_viewer::scan_max;
+std::chrono::milliseconds constexpr chratos_qt::wallet::refresh_interval;
+
 chratos_qt::dividends::dividends (chratos_qt::wallet & wallet_a) :
 window (new QWidget),
 dividends_paid_label (new QLabel),
@@ -322,7 +355,11 @@ claim_all_dividends (new QPushButton ("Claim All Unclaimed")),
 claim_dividend (new QPushButton ("Claim Dividend")),
 separator (new QFrame),
 back (new QPushButton ("Back")),
-wallet (wallet_a)
+wallet (wallet_a),
+oldest (chratos::dividend_base),
+account_dividend (chratos::dividend_base),
+loading (false),
+generation (0)
 {
 	separator->setFrameShape (QFrame::HLine);
 	separator->setFrameShadow (QFrame::Sunken);
@@ -348,7 +385,7 @@ wallet (wallet_a)
 	});
 
   QObject::connect (claim_all_dividends, &QPushButton::released, [this]() {
-    this->wallet.wallet_m->claim_dividends ();
+    this->wallet.wallet_m->claim_dividends_async ([](std::vector<chratos::dividend_claim_result>) {});
   });
 
   QObject::connect (claim_dividend, &QPushButton::released, [this]() {
@@ -370,99 +407,213 @@ wallet (wallet_a)
       assert (!error);
 
       chratos::account representative (this->wallet.wallet_m->store.representative (transaction));
-      std::shared_ptr<chratos::block> dividend_l (this->wallet.node.store.block_get (transaction, hash));
-      // Check pending and claim outstanding
-      this->wallet.wallet_m->receive_outstanding_pendings_async (transaction, account, hash, [this, &dividend_l, &info, &account, &representative]() {
-        // Check dividend points to the account's last claimed
-        if (info.dividend_block == dividend_l->dividend ())
-        {
-          this->wallet.wallet_m->claim_dividend_async (dividend_l, account, representative, [](std::shared_ptr<chratos::block> block) {
-          });
-        }
+      // Receive and claim every dividend up to the selected one as a single chain
+      this->wallet.wallet_m->claim_chain_async (account, representative, hash, [](std::vector<std::shared_ptr<chratos::block>>) {
       });
     }
   });
 
+	QObject::connect (view->verticalScrollBar (), &QScrollBar::valueChanged, [this](int value_a) {
+		if (value_a >= view->verticalScrollBar ()->maximum ())
+		{
+			load_older ();
+		}
+	});
+
 	QObject::connect (back, &QPushButton::clicked, [this]() {
 		this->wallet.pop_main_stack ();
 	});
-
-	refresh_dividends_paid ();
-  refresh ();
 }
 
 void chratos_qt::dividends::refresh_dividends_paid ()
 {
-	chratos::transaction transaction (this->wallet.wallet_m->store.environment, nullptr, false);
-
-	chratos::uint128_t paid (0);
-
-  auto dividend_info (this->wallet.node.store.dividend_get (transaction));
-
-  auto block (this->wallet.node.store.block_get (transaction, dividend_info.head));
-
-  while (block != nullptr)
-  {
-    paid = paid + (this->wallet.node.ledger.amount (transaction, block->hash ()));
-    block = (this->wallet.node.store.block_get (transaction, block->dividend ()));
-  }
-
-  auto final_text (std::string ("Paid: ") + wallet.format_balance (paid));
-
-  dividends_paid_label->setText (QString (final_text.c_str ()));
-	this->wallet.node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (60), [this]() {
-		this->wallet.application.postEvent (&this->wallet.processor, new eventloop_event ([this]() {
-			refresh_dividends_paid ();
-      refresh ();
-		}));
-  });
+	// The dividend info keeps a running total of everything paid so the chain doesn't need walking
+	std::weak_ptr<chratos_qt::wallet> wallet_w (wallet.shared_from_this ());
+	wallet.node.background ([wallet_w]() {
+		if (auto wallet_l = wallet_w.lock ())
+		{
+			chratos::uint128_t paid;
+			{
+				chratos::transaction transaction (wallet_l->node.store.environment, nullptr, false);
+				paid = wallet_l->node.store.dividend_get (transaction).balance.number ();
+			}
+			wallet_l->application.postEvent (&wallet_l->processor, new eventloop_event ([wallet_w, paid]() {
+				if (auto wallet_l = wallet_w.lock ())
+				{
+					auto final_text (std::string ("Paid: ") + wallet_l->format_balance (paid));
+					wallet_l->dividends.dividends_paid_label->setText (QString (final_text.c_str ()));
+				}
+			}));
+		}
+	});
 }
 
 void chratos_qt::dividends::refresh ()
 {
+	++generation;
 	model->removeRows (0, model->rowCount ());
-	chratos::transaction transaction (wallet.wallet_m->store.environment, nullptr, false);
-
-  auto dividend_info (this->wallet.node.store.dividend_get (transaction));
-
-  auto block (this->wallet.node.store.block_get (transaction, dividend_info.head));
-
-  chratos::account_info info;
-
-  auto error (this->wallet.node.store.account_get (transaction, this->wallet.account, info));
-
-  assert (!error);
-
-  while (block != nullptr)
-  {
-    QList<QStandardItem *> items;
-  
-    auto hash (block->hash ());
-
-    auto dividend_amount (this->wallet.node.ledger.amount (transaction, hash));
-    chratos::amount claimed_amount (this->wallet.node.ledger.amount_for_dividend (transaction, hash, this->wallet.account));
-    std::string balance = wallet.format_balance (dividend_amount);
-    items.push_back (new QStandardItem (balance.c_str ()));
-    items.push_back (new QStandardItem (hash.to_string ().c_str ()));
+	rows.clear ();
+	shown.clear ();
+	oldest = chratos::not_a_block;
+	account_dividend = chratos::dividend_base;
+	loading = false;
+	refresh_dividends_paid ();
+	refresh_claimed ();
+	load_older ();
+}
 
-    std::string claimed_balance = wallet.format_balance (claimed_amount.number ());
+void chratos_qt::dividends::load_older ()
+{
+	if (!loading && oldest != chratos::dividend_base)
+	{
+		loading = true;
+		std::weak_ptr<chratos_qt::wallet> wallet_w (wallet.shared_from_this ());
+		auto account (wallet.account);
+		auto from (oldest);
+		auto generation_l (generation);
+		wallet.node.background ([wallet_w, account, from, generation_l]() {
+			if (auto wallet_l = wallet_w.lock ())
+			{
+				auto & node (wallet_l->node);
+				std::vector<chratos_qt::dividends::row> rows;
+				auto hash (from);
+				{
+					chratos::transaction transaction (node.store.environment, nullptr, false);
+					if (hash == chratos::not_a_block)
+					{
+						hash = node.store.dividend_get (transaction).head;
+					}
+					while (rows.size () < chratos_qt::dividends::page_size && hash != chratos::dividend_base)
+					{
+						auto block (node.store.block_get (transaction, hash));
+						if (block != nullptr)
+						{
+							rows.push_back ({ hash, node.ledger.amount (transaction, hash), node.ledger.amount_for_dividend (transaction, hash, account), block->account () });
+							hash = block->dividend ();
+						}
+						else
+						{
+							hash = chratos::dividend_base;
+						}
+					}
+				}
+				wallet_l->application.postEvent (&wallet_l->processor, new eventloop_event ([wallet_w, rows, hash, generation_l]() {
+					if (auto wallet_l = wallet_w.lock ())
+					{
+						auto & dividends (wallet_l->dividends);
+						if (dividends.generation == generation_l)
+						{
+							dividends.oldest = hash;
+							dividends.loading = false;
+							dividends.insert (rows, false);
+						}
+					}
+				}));
+			}
+		});
+	}
+}
 
-    if (this->wallet.node.ledger.dividends_are_ordered (transaction, hash, info.dividend_block))
-    {
-      items.push_back (new QStandardItem (claimed_balance.c_str ()));
-    }
-    else
-    {
-      std::string claimed_str = claimed_balance + " (Unclaimed)";
-      items.push_back (new QStandardItem (claimed_str.c_str ()));
-    }
+void chratos_qt::dividends::dividend_added (chratos::block_hash const & hash_a)
+{
+	std::weak_ptr<chratos_qt::wallet> wallet_w (wallet.shared_from_this ());
+	auto account (wallet.account);
+	auto generation_l (generation);
+	wallet.node.background ([wallet_w, account, hash_a, generation_l]() {
+		if (auto wallet_l = wallet_w.lock ())
+		{
+			auto & node (wallet_l->node);
+			std::vector<chratos_qt::dividends::row> rows;
+			{
+				chratos::transaction transaction (node.store.environment, nullptr, false);
+				auto block (node.store.block_get (transaction, hash_a));
+				if (block != nullptr)
+				{
+					rows.push_back ({ hash_a, node.ledger.amount (transaction, hash_a), node.ledger.amount_for_dividend (transaction, hash_a, account), block->account () });
+				}
+			}
+			wallet_l->application.postEvent (&wallet_l->processor, new eventloop_event ([wallet_w, rows, generation_l]() {
+				if (auto wallet_l = wallet_w.lock ())
+				{
+					auto & dividends (wallet_l->dividends);
+					if (dividends.generation == generation_l)
+					{
+						dividends.insert (rows, true);
+					}
+				}
+			}));
+		}
+	});
+	refresh_dividends_paid ();
+}
 
-    items.push_back (new QStandardItem (block->account ().to_account ().c_str ()));
+void chratos_qt::dividends::refresh_claimed ()
+{
+	std::weak_ptr<chratos_qt::wallet> wallet_w (wallet.shared_from_this ());
+	auto account (wallet.account);
+	auto generation_l (generation);
+	wallet.node.background ([wallet_w, account, generation_l]() {
+		if (auto wallet_l = wallet_w.lock ())
+		{
+			chratos::account_info info;
+			{
+				chratos::transaction transaction (wallet_l->node.store.environment, nullptr, false);
+				wallet_l->node.store.account_get (transaction, account, info);
+			}
+			auto dividend (info.dividend_block);
+			wallet_l->application.postEvent (&wallet_l->processor, new eventloop_event ([wallet_w, dividend, generation_l]() {
+				if (auto wallet_l = wallet_w.lock ())
+				{
+					auto & dividends (wallet_l->dividends);
+					if (dividends.generation == generation_l)
+					{
+						dividends.set_account_dividend (dividend);
+					}
+				}
+			}));
+		}
+	});
+}
 
-    model->appendRow (items);
+void chratos_qt::dividends::insert (std::vector<chratos_qt::dividends::row> const & rows_a, bool newest_a)
+{
+	// Rows are newest first and everything from the account's latest dividend downwards counts as claimed
+	auto claimed (!newest_a && shown.count (account_dividend) != 0);
+	for (auto i (rows_a.begin ()), n (rows_a.end ()); i != n; ++i)
+	{
+		if (shown.insert (i->hash).second)
+		{
+			claimed = claimed || i->hash == account_dividend;
+			auto claimed_text (wallet.format_balance (i->claimed.number ()) + (claimed ? "" : " (Unclaimed)"));
+			QList<QStandardItem *> items;
+			items.push_back (new QStandardItem (wallet.format_balance (i->amount.number ()).c_str ()));
+			items.push_back (new QStandardItem (i->hash.to_string ().c_str ()));
+			items.push_back (new QStandardItem (claimed_text.c_str ()));
+			items.push_back (new QStandardItem (i->from.to_account ().c_str ()));
+			if (newest_a)
+			{
+				model->insertRow (0, items);
+				rows.push_front (*i);
+			}
+			else
+			{
+				model->appendRow (items);
+				rows.push_back (*i);
+			}
+		}
+	}
+}
 
-    block = (this->wallet.node.store.block_get (transaction, block->dividend ()));
-  }
+void chratos_qt::dividends::set_account_dividend (chratos::block_hash const & dividend_a)
+{
+	account_dividend = dividend_a;
+	auto claimed (false);
+	for (size_t i (0), n (rows.size ()); i < n; ++i)
+	{
+		claimed = claimed || rows[i].hash == account_dividend;
+		auto claimed_text (wallet.format_balance (rows[i].claimed.number ()) + (claimed ? "" : " (Unclaimed)"));
+		model->item (i, 2)->setText (QString (claimed_text.c_str ()));
+	}
 }
 
 chratos_qt::claims_viewer::claims_viewer (chratos_qt::wallet & wallet_a) :
@@ -472,7 +623,10 @@ total_claimed_label (new QLabel),
 model (new QStandardItemModel),
 view (new QTableView),
 back (new QPushButton ("Back")),
-wallet (wallet_a)
+wallet (wallet_a),
+oldest (0),
+loading (false),
+generation (0)
 {
 	model->setHorizontalHeaderItem (0, new QStandardItem ("Amount"));
 	model->setHorizontalHeaderItem (2, new QStandardItem ("Dividend"));
@@ -487,50 +641,118 @@ wallet (wallet_a)
 	layout->addWidget (back);
 	window->setLayout (layout);
 
+	QObject::connect (view->verticalScrollBar (), &QScrollBar::valueChanged, [this](int value_a) {
+		if (value_a >= view->verticalScrollBar ()->maximum ())
+		{
+			load_older ();
+		}
+	});
+
 	QObject::connect (back, &QPushButton::clicked, [this]() {
 		this->wallet.pop_main_stack ();
 	});
-
-  refresh ();
 }
 
 void chratos_qt::claims_viewer::refresh ()
 {
+	++generation;
 	model->removeRows (0, model->rowCount ());
-	chratos::transaction transaction (wallet.wallet_m->store.environment, nullptr, false);
-
-  chratos::account_info info;
-
-  auto error (this->wallet.node.store.account_get (transaction, this->wallet.account, info));
-  assert (!error);
-
-  auto block = this->wallet.node.store.block_get (transaction, info.head);
-
-  while (block != nullptr)
-  {
-    QList<QStandardItem *> items;
-  
-    if (block->type () == chratos::block_type::claim)
-    { 
-      auto hash (block->hash ());
-      auto dividend (block->dividend ());
-      auto claimed_amount (this->wallet.node.ledger.amount (transaction, hash));
-      std::string balance = wallet.format_balance (claimed_amount);
-      items.push_back (new QStandardItem (balance.c_str ()));
-      items.push_back (new QStandardItem (dividend.to_string ().c_str ()));
-      items.push_back (new QStandardItem (hash.to_string ().c_str ()));
-      model->appendRow (items);
-    }
+	shown.clear ();
+	oldest = chratos::not_a_block;
+	loading = false;
+	load_older ();
+}
 
-    block = (this->wallet.node.store.block_get (transaction, block->previous ()));
-  }
+void chratos_qt::claims_viewer::load_older ()
+{
+	if (!loading && !oldest.is_zero ())
+	{
+		loading = true;
+		std::weak_ptr<chratos_qt::wallet> wallet_w (wallet.shared_from_this ());
+		auto account (wallet.account);
+		auto from (oldest);
+		auto generation_l (generation);
+		wallet.node.background ([wallet_w, account, from, generation_l]() {
+			if (auto wallet_l = wallet_w.lock ())
+			{
+				auto & node (wallet_l->node);
+				std::vector<chratos_qt::claims_viewer::row> rows;
+				auto hash (from);
+				{
+					chratos::transaction transaction (node.store.environment, nullptr, false);
+					if (hash == chratos::not_a_block)
+					{
+						chratos::account_info info;
+						hash = node.store.account_get (transaction, account, info) ? chratos::block_hash (0) : info.head;
+					}
+					for (size_t scanned (0); rows.size () < chratos_qt::claims_viewer::page_size && scanned < chratos_qt::claims_viewer::scan_max && !hash.is_zero (); ++scanned)
+					{
+						auto block (node.store.block_get (transaction, hash));
+						if (block != nullptr)
+						{
+							if (block->type () == chratos::block_type::claim)
+							{
+								rows.push_back ({ hash, block->dividend (), node.ledger.amount (transaction, hash) });
+							}
+							hash = block->previous ();
+						}
+						else
+						{
+							hash.clear ();
+						}
+					}
+				}
+				wallet_l->application.postEvent (&wallet_l->processor, new eventloop_event ([wallet_w, rows, hash, generation_l]() {
+					if (auto wallet_l = wallet_w.lock ())
+					{
+						auto & claims (wallet_l->claims_viewer);
+						if (claims.generation == generation_l)
+						{
+							claims.oldest = hash;
+							claims.loading = false;
+							claims.insert (rows, false);
+							// Keep going while the rows don't fill the view or it's still scrolled to the bottom, otherwise wait for the next scroll
+							auto scroll (claims.view->verticalScrollBar ());
+							if (scroll->value () >= scroll->maximum ())
+							{
+								claims.load_older ();
+							}
+						}
+					}
+				}));
+			}
+		});
+	}
+}
 
-	this->wallet.node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (60), [this]() {
-		this->wallet.application.postEvent (&this->wallet.processor, new eventloop_event ([this]() {
-			refresh ();
-		}));
-	});
+void chratos_qt::claims_viewer::claim_added (std::shared_ptr<chratos::block> block_a, chratos::uint128_t const & amount_a)
+{
+	if (block_a->type () == chratos::block_type::claim)
+	{
+		insert ({ { block_a->hash (), block_a->dividend (), amount_a } }, true);
+	}
+}
 
+void chratos_qt::claims_viewer::insert (std::vector<chratos_qt::claims_viewer::row> const & rows_a, bool newest_a)
+{
+	for (auto i (rows_a.begin ()), n (rows_a.end ()); i != n; ++i)
+	{
+		if (shown.insert (i->hash).second)
+		{
+			QList<QStandardItem *> items;
+			items.push_back (new QStandardItem (wallet.format_balance (i->amount.number ()).c_str ()));
+			items.push_back (new QStandardItem (i->dividend.to_string ().c_str ()));
+			items.push_back (new QStandardItem (i->hash.to_string ().c_str ()));
+			if (newest_a)
+			{
+				model->insertRow (0, items);
+			}
+			else
+			{
+				model->appendRow (items);
+			}
+		}
+	}
 }
 
 chratos_qt::import::import (chratos_qt::wallet & wallet_a) :
@@ -1197,7 +1419,8 @@ send_count_label (new QLabel ("Amount:")),
 send_count (new QLineEdit),
 send_blocks_send (new QPushButton ("Send")),
 send_blocks_back (new QPushButton ("Back")),
-active_status (*this)
+active_status (*this),
+refresh_scheduled (false)
 {
 	update_connected ();
 	empty_password ();
@@ -1448,33 +1671,30 @@ void chratos_qt::wallet::start ()
 	node.observers.blocks.add ([this_w](std::shared_ptr<chratos::block> block_a, chratos::account const & account_a, chratos::uint128_t const & amount_a, bool) {
 		if (auto this_l = this_w.lock ())
 		{
-			this_l->application.postEvent (&this_l->processor, new eventloop_event ([this_w, block_a, account_a]() {
-				if (auto this_l = this_w.lock ())
-				{
-					if (this_l->wallet_m->exists (account_a))
-					{
-						this_l->accounts.refresh ();
-					}
-					if (account_a == this_l->account)
+			this_l->queue_refresh (account_a);
+			if (block_a->type () == chratos::block_type::dividend || block_a->type () == chratos::block_type::claim)
+			{
+				this_l->application.postEvent (&this_l->processor, new eventloop_event ([this_w, block_a, account_a, amount_a]() {
+					if (auto this_l = this_w.lock ())
 					{
-						this_l->history.refresh ();
+						if (block_a->type () == chratos::block_type::dividend)
+						{
+							this_l->dividends.dividend_added (block_a->hash ());
+						}
+						else if (account_a == this_l->account)
+						{
+							this_l->claims_viewer.claim_added (block_a, amount_a);
+							this_l->dividends.refresh_claimed ();
+						}
 					}
-				}
-			}));
+				}));
+			}
 		}
 	});
 	node.observers.account_balance.add ([this_w](chratos::account const & account_a, bool is_pending) {
 		if (auto this_l = this_w.lock ())
 		{
-			this_l->application.postEvent (&this_l->processor, new eventloop_event ([this_w, account_a]() {
-				if (auto this_l = this_w.lock ())
-				{
-					if (account_a == this_l->account)
-					{
-						this_l->self.refresh_balance ();
-					}
-				}
-			}));
+			this_l->queue_refresh (account_a);
 		}
 	});
 	node.observers.wallet.add ([this_w](bool active_a) {
@@ -1565,6 +1785,8 @@ void chratos_qt::wallet::start ()
 		}
 	};
 	settings_button->setToolTip ("Unlock wallet, set password, change representative");
+	dividends.refresh ();
+	claims_viewer.refresh ();
 }
 
 void chratos_qt::wallet::refresh ()
@@ -1577,8 +1799,51 @@ void chratos_qt::wallet::refresh ()
 	self.refresh_balance ();
 	accounts.refresh ();
 	history.refresh ();
-	account_viewer.history.refresh ();
 	settings.refresh_representative ();
+	dividends.refresh ();
+	claims_viewer.refresh ();
+}
+
+void chratos_qt::wallet::queue_refresh (chratos::account const & account_a)
+{
+	std::lock_guard<std::mutex> lock (refresh_mutex);
+	refresh_accounts.insert (account_a);
+	if (!refresh_scheduled)
+	{
+		refresh_scheduled = true;
+		std::weak_ptr<chratos_qt::wallet> this_w (shared_from_this ());
+		node.alarm.add (std::chrono::steady_clock::now () + refresh_interval, [this_w]() {
+			if (auto this_l = this_w.lock ())
+			{
+				this_l->application.postEvent (&this_l->processor, new eventloop_event ([this_w]() {
+					if (auto this_l = this_w.lock ())
+					{
+						this_l->flush_refresh ();
+					}
+				}));
+			}
+		});
+	}
+}
+
+void chratos_qt::wallet::flush_refresh ()
+{
+	std::unordered_set<chratos::account> accounts_l;
+	{
+		std::lock_guard<std::mutex> lock (refresh_mutex);
+		accounts_l.swap (refresh_accounts);
+		refresh_scheduled = false;
+	}
+	accounts.refresh_accounts (accounts_l);
+	if (accounts_l.count (account) != 0)
+	{
+		self.refresh_balance ();
+		history.refresh ();
+	}
+	if (accounts_l.count (account_viewer.account) != 0)
+	{
+		account_viewer.history.refresh ();
+	}
 }
 
 void chratos_qt::wallet::update_connected ()
@@ -1785,9 +2050,7 @@ wallet (wallet_a)
 		if (this->wallet.wallet_m->store.valid_password (transaction))
 		{
 			// lock wallet
-			chratos::raw_key empty;
-			empty.data.clear ();
-			this->wallet.wallet_m->store.password.value_set (empty);
+			this->wallet.wallet_m->store.lock ();
 			update_locked (true, true);
 			lock_toggle->setText ("Unlock");
 			password->setEnabled (1);
@@ -2047,7 +2310,7 @@ wallet (wallet_a)
 		this->wallet.wallet_m->search_pending ();
 	});
   QObject::connect (claim_dividends, &QPushButton::released, [this]() {
-    this->wallet.wallet_m->claim_dividends ();
+    this->wallet.wallet_m->claim_dividends_async ([](std::vector<chratos::dividend_claim_result>) {});
   });
 	QObject::connect (bootstrap, &QPushButton::released, [this]() {
 		this->wallet.node.bootstrap_initiator.bootstrap ();
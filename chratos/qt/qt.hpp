@@ -4,6 +4,7 @@
 
 #include <boost/thread.hpp>
 
+#include <deque>
 #include <set>
 
 #include <QtGui>
@@ -172,6 +173,7 @@ class accounts
 public:
 	accounts (chratos_qt::wallet &);
 	void refresh ();
+	void refresh_accounts (std::unordered_set<chratos::account> const &);
 	void refresh_wallet_balance ();
 	QLabel * wallet_balance_label;
 	QWidget * window;
@@ -188,12 +190,38 @@ public:
 	QPushButton * back;
 	chratos_qt::wallet & wallet;
 };
+/**
+ * Dividend list filled a page at a time off the GUI thread, newest first.
+ * New dividends and claims arrive from block observers; older dividends are fetched as the view is scrolled.
+ */
 class dividends
 {
 public:
   dividends (chratos_qt::wallet &);
 	void refresh ();
 	void refresh_dividends_paid ();
+	void load_older ();
+	void dividend_added (chratos::block_hash const &);
+	void refresh_claimed ();
+	class row
+	{
+	public:
+		chratos::block_hash hash;
+		chratos::amount amount;
+		chratos::amount claimed;
+		chratos::account from;
+	};
+	void insert (std::vector<chratos_qt::dividends::row> const &, bool);
+	void set_account_dividend (chratos::block_hash const &);
+	std::deque<chratos_qt::dividends::row> rows;
+	std::unordered_set<chratos::block_hash> shown;
+	// Next older dividend to fetch, dividend_base once the whole chain is shown
+	chratos::block_hash oldest;
+	chratos::block_hash account_dividend;
+	bool loading;
+	// Bumped on every refresh so pages fetched for a previous account are dropped
+	uint64_t generation;
+	static size_t constexpr page_size = 64;
 	QLabel * dividends_paid_label;
 	QWidget * window;
 	QVBoxLayout * layout;
@@ -206,11 +234,30 @@ public:
 	QPushButton * back;
 	chratos_qt::wallet & wallet;
 };
+/** Claims of the selected account, filled incrementally the same way as the dividend list */
 class claims_viewer
 {
 public:
   claims_viewer (chratos_qt::wallet &);
 	void refresh ();
+	void load_older ();
+	void claim_added (std::shared_ptr<chratos::block>, chratos::uint128_t const &);
+	class row
+	{
+	public:
+		chratos::block_hash hash;
+		chratos::block_hash dividend;
+		chratos::amount amount;
+	};
+	void insert (std::vector<chratos_qt::claims_viewer::row> const &, bool);
+	std::unordered_set<chratos::block_hash> shown;
+	// Next block of the account chain to scan, zero once the open block has been reached
+	chratos::block_hash oldest;
+	bool loading;
+	uint64_t generation;
+	static size_t constexpr page_size = 64;
+	// Blocks read per page, an account with few claims is scanned over several pages rather than all at once
+	static size_t constexpr scan_max = 4096;
 	QLabel * total_claimed_label;
 	QWidget * window;
 	QVBoxLayout * layout;
@@ -385,5 +432,12 @@ public:
 	chratos_qt::status active_status;
 	void pop_main_stack ();
 	void push_main_stack (QWidget *);
+	// Block notifications are collected here and applied once per refresh_interval instead of once per block
+	void queue_refresh (chratos::account const &);
+	void flush_refresh ();
+	std::mutex refresh_mutex;
+	std::unordered_set<chratos::account> refresh_accounts;
+	bool refresh_scheduled;
+	static std::chrono::milliseconds constexpr refresh_interval = std::chrono::milliseconds (100);
 };
 }
@@ -51,6 +51,27 @@ public:
 };
 }
 
+namespace
+{
+/**
+ * Insert or overwrite a value with one lookup, the cursor left by MDB_SET is reused to write in place
+ * Returns true if the key was new
+ */
+bool mdb_upsert (MDB_txn * transaction_a, MDB_dbi database_a, MDB_val * key_a, MDB_val * value_a)
+{
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (transaction_a, database_a, &cursor));
+	assert (status == 0);
+	MDB_val existing;
+	auto status2 (mdb_cursor_get (cursor, key_a, &existing, MDB_SET));
+	assert (status2 == 0 || status2 == MDB_NOTFOUND);
+	auto status3 (mdb_cursor_put (cursor, key_a, value_a, status2 == 0 ? MDB_CURRENT : 0));
+	assert (status3 == 0);
+	mdb_cursor_close (cursor);
+	return status2 == MDB_NOTFOUND;
+}
+}
+
 template <typename T, typename U>
 chratos::mdb_iterator<T, U>::mdb_iterator (MDB_txn * transaction_a, MDB_dbi db_a, chratos::epoch epoch_a) :
 cursor (nullptr)
@@ -409,11 +430,19 @@ state_blocks_v1 (0),
 pending_v0 (0),
 pending_v1 (0),
 blocks_info (0),
+confirmation_height (0),
 representation (0),
 unchecked (0),
 checksum (0),
 vote (0),
-meta (0)
+meta (0),
+state_v0_count (0),
+state_v1_count (0),
+dividend_count (0),
+claim_count (0),
+accounts_v0_count (0),
+accounts_v1_count (0),
+unchecked_entries (0)
 {
 	if (!error_a)
 	{
@@ -434,6 +463,7 @@ meta (0)
 		error_a |= mdb_dbi_open (transaction, "pending", MDB_CREATE, &pending_v0) != 0;
 		error_a |= mdb_dbi_open (transaction, "pending_v1", MDB_CREATE, &pending_v1) != 0;
 		error_a |= mdb_dbi_open (transaction, "blocks_info", MDB_CREATE, &blocks_info) != 0;
+		error_a |= mdb_dbi_open (transaction, "confirmation_height", MDB_CREATE, &confirmation_height) != 0;
 		error_a |= mdb_dbi_open (transaction, "representation", MDB_CREATE, &representation) != 0;
 		error_a |= mdb_dbi_open (transaction, "unchecked", MDB_CREATE | MDB_DUPSORT, &unchecked) != 0;
 		error_a |= mdb_dbi_open (transaction, "checksum", MDB_CREATE, &checksum) != 0;
@@ -442,6 +472,7 @@ meta (0)
 		if (!error_a)
 		{
 			do_upgrades (transaction);
+			counts_seed (transaction);
 			checksum_put (transaction, 0, 0, 0);
 		}
 	}
@@ -457,6 +488,7 @@ void chratos::block_store::initialize (MDB_txn * transaction_a, chratos::genesis
 	representation_put (transaction_a, genesis_account, std::numeric_limits<chratos::uint128_t>::max ());
 	checksum_put (transaction_a, 0, 0, hash_l);
 	frontier_put (transaction_a, hash_l, genesis_account);
+	confirmation_height_put (transaction_a, genesis_account, chratos::confirmation_height_info (1, hash_l));
   dividend_put (transaction_a, dividend_info());
 }
 
@@ -540,6 +572,8 @@ void chratos::block_store::do_upgrades (MDB_txn * transaction_a)
 		case 10:
 			upgrade_v10_to_v11 (transaction_a);
 		case 11:
+			upgrade_v11_to_v12 (transaction_a);
+		case 12:
 			break;
 		default:
 			assert (false);
@@ -743,6 +777,17 @@ void chratos::block_store::upgrade_v10_to_v11 (MDB_txn * transaction_a)
 	mdb_drop (transaction_a, unsynced, 1);
 }
 
+void chratos::block_store::upgrade_v11_to_v12 (MDB_txn * transaction_a)
+{
+	version_put (transaction_a, 12);
+	// The genesis block is the only one known to be confirmed, everything else is cemented as elections confirm it
+	chratos::account_info info;
+	if (!account_get (transaction_a, chratos::genesis_account, info))
+	{
+		confirmation_height_put (transaction_a, chratos::genesis_account, chratos::confirmation_height_info (1, info.open_block));
+	}
+}
+
 void chratos::block_store::clear (MDB_dbi db_a)
 {
 	chratos::transaction transaction (environment, nullptr, true);
@@ -828,7 +873,13 @@ void chratos::block_store::block_put (MDB_txn * transaction_a, chratos::block_ha
 		block_a.serialize (stream);
 		chratos::write (stream, successor_a.bytes);
 	}
-	block_raw_put (transaction_a, block_database (block_a.type (), epoch_a), hash_a, { vector.size (), vector.data () });
+	auto database (block_database (block_a.type (), epoch_a));
+	MDB_val value{ vector.size (), vector.data () };
+	// Existing blocks are rewritten e.g. to clear their successor, only new ones are counted
+	if (mdb_upsert (transaction_a, database, chratos::mdb_val (hash_a), &value))
+	{
+		++*table_count (database);
+	}
 	chratos::block_predecessor_set predecessor (transaction_a, *this);
 	block_a.visit (predecessor);
 	assert (block_a.previous ().is_zero () || block_successor (transaction_a, block_a.previous ()) == hash_a);
@@ -888,8 +939,13 @@ std::unique_ptr<chratos::block> chratos::block_store::block_random (MDB_txn * tr
 		existing = chratos::store_iterator<chratos::block_hash, std::shared_ptr<T>> (std::make_unique<chratos::mdb_iterator<chratos::block_hash, std::shared_ptr<T>>> (transaction_a, database));
 	}
 	auto end (chratos::store_iterator<chratos::block_hash, std::shared_ptr<T>> (nullptr));
-	assert (existing != end);
-	return block_get (transaction_a, chratos::block_hash (existing->first));
+	std::unique_ptr<chratos::block> result;
+	// The cached counts can include blocks from a write transaction this one doesn't see yet
+	if (existing != end)
+	{
+		result = block_get (transaction_a, chratos::block_hash (existing->first));
+	}
+	return result;
 }
 
 std::unique_ptr<chratos::block> chratos::block_store::block_random (MDB_txn * transaction_a)
@@ -921,6 +977,10 @@ std::unique_ptr<chratos::block> chratos::block_store::block_random (MDB_txn * tr
       }
     }
   }
+	if (result == nullptr)
+	{
+		result = block_random<chratos::state_block> (transaction_a, state_blocks_v0);
+	}
 	assert (result != nullptr);
 	return result;
 }
@@ -981,8 +1041,21 @@ void chratos::block_store::block_del (MDB_txn * transaction_a, chratos::block_ha
       {
         auto status (mdb_del (transaction_a, claim_blocks, chratos::mdb_val (hash_a), nullptr));
         assert (status == 0);
+        --claim_count;
+      }
+      else
+      {
+        --dividend_count;
       }
     }
+    else
+    {
+      --state_v0_count;
+    }
+  }
+  else
+  {
+    --state_v1_count;
   }
 }
 
@@ -1015,6 +1088,16 @@ bool chratos::block_store::block_exists (MDB_txn * transaction_a, chratos::block
 }
 
 chratos::block_counts chratos::block_store::block_count (MDB_txn * transaction_a)
+{
+	chratos::block_counts result;
+	result.state_v0 = state_v0_count;
+	result.state_v1 = state_v1_count;
+	result.dividend = dividend_count;
+	result.claim = claim_count;
+	return result;
+}
+
+chratos::block_counts chratos::block_store::block_count_stat (MDB_txn * transaction_a)
 {
 	chratos::block_counts result;
 	MDB_stat state_v0_stats;
@@ -1049,6 +1132,11 @@ void chratos::block_store::account_del (MDB_txn * transaction_a, chratos::accoun
 		assert (status1 == MDB_NOTFOUND);
 		auto status2 (mdb_del (transaction_a, accounts_v0, chratos::mdb_val (account_a), nullptr));
 		assert (status2 == 0);
+		--accounts_v0_count;
+	}
+	else
+	{
+		--accounts_v1_count;
 	}
 }
 
@@ -1132,6 +1220,11 @@ void chratos::block_store::frontier_del (MDB_txn * transaction_a, chratos::block
 }
 
 size_t chratos::block_store::account_count (MDB_txn * transaction_a)
+{
+	return accounts_v0_count + accounts_v1_count;
+}
+
+size_t chratos::block_store::account_count_stat (MDB_txn * transaction_a)
 {
 	MDB_stat stats1;
 	auto status1 (mdb_stat (transaction_a, accounts_v0, &stats1));
@@ -1158,8 +1251,76 @@ void chratos::block_store::account_put (MDB_txn * transaction_a, chratos::accoun
 			db = accounts_v1;
 			break;
 	}
-	auto status (mdb_put (transaction_a, db, chratos::mdb_val (account_a), chratos::mdb_val (info_a), 0));
+	chratos::mdb_val value (info_a);
+	if (mdb_upsert (transaction_a, db, chratos::mdb_val (account_a), value))
+	{
+		++*table_count (db);
+	}
+}
+
+std::atomic<size_t> * chratos::block_store::table_count (MDB_dbi database_a)
+{
+	std::atomic<size_t> * result (nullptr);
+	if (database_a == state_blocks_v0)
+	{
+		result = &state_v0_count;
+	}
+	else if (database_a == state_blocks_v1)
+	{
+		result = &state_v1_count;
+	}
+	else if (database_a == dividend_blocks)
+	{
+		result = &dividend_count;
+	}
+	else if (database_a == claim_blocks)
+	{
+		result = &claim_count;
+	}
+	else if (database_a == accounts_v0)
+	{
+		result = &accounts_v0_count;
+	}
+	else if (database_a == accounts_v1)
+	{
+		result = &accounts_v1_count;
+	}
+	assert (result != nullptr);
+	return result;
+}
+
+void chratos::block_store::counts_seed (MDB_txn * transaction_a)
+{
+	auto blocks (block_count_stat (transaction_a));
+	state_v0_count = blocks.state_v0;
+	state_v1_count = blocks.state_v1;
+	dividend_count = blocks.dividend;
+	claim_count = blocks.claim;
+	MDB_stat stats;
+	auto status1 (mdb_stat (transaction_a, accounts_v0, &stats));
+	assert (status1 == 0);
+	accounts_v0_count = stats.ms_entries;
+	auto status2 (mdb_stat (transaction_a, accounts_v1, &stats));
+	assert (status2 == 0);
+	accounts_v1_count = stats.ms_entries;
+	auto status3 (mdb_stat (transaction_a, unchecked, &stats));
+	assert (status3 == 0);
+	unchecked_entries = stats.ms_entries;
+}
+
+bool chratos::block_store::counts_verify (MDB_txn * transaction_a)
+{
+	auto cached (block_count (transaction_a));
+	auto stat (block_count_stat (transaction_a));
+	MDB_stat unchecked_stats;
+	auto status (mdb_stat (transaction_a, unchecked, &unchecked_stats));
 	assert (status == 0);
+	auto result (cached.state_v0 != stat.state_v0 || cached.state_v1 != stat.state_v1 || cached.dividend != stat.dividend || cached.claim != stat.claim || account_count (transaction_a) != account_count_stat (transaction_a) || unchecked_entries != unchecked_stats.ms_entries);
+	if (result)
+	{
+		counts_seed (transaction_a);
+	}
+	return result;
 }
 
 void chratos::block_store::dividend_put (MDB_txn * transaction_a, chratos::dividend_info const & info_a)
@@ -1334,6 +1495,38 @@ bool chratos::block_store::block_info_get (MDB_txn * transaction_a, chratos::blo
 	return result;
 }
 
+void chratos::block_store::confirmation_height_put (MDB_txn * transaction_a, chratos::account const & account_a, chratos::confirmation_height_info const & info_a)
+{
+	std::vector<uint8_t> vector;
+	{
+		chratos::vectorstream stream (vector);
+		info_a.serialize (stream);
+	}
+	auto status (mdb_put (transaction_a, confirmation_height, chratos::mdb_val (account_a), chratos::mdb_val (vector.size (), vector.data ()), 0));
+	assert (status == 0);
+}
+
+bool chratos::block_store::confirmation_height_get (MDB_txn * transaction_a, chratos::account const & account_a, chratos::confirmation_height_info & info_a)
+{
+	chratos::mdb_val value;
+	auto status (mdb_get (transaction_a, confirmation_height, chratos::mdb_val (account_a), value));
+	assert (status == 0 || status == MDB_NOTFOUND);
+	bool result (true);
+	if (status == 0)
+	{
+		chratos::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+		result = info_a.deserialize (stream);
+		assert (!result);
+	}
+	return result;
+}
+
+void chratos::block_store::confirmation_height_del (MDB_txn * transaction_a, chratos::account const & account_a)
+{
+	auto status (mdb_del (transaction_a, confirmation_height, chratos::mdb_val (account_a), nullptr));
+	assert (status == 0 || status == MDB_NOTFOUND);
+}
+
 chratos::uint128_t chratos::block_store::representation_get (MDB_txn * transaction_a, chratos::account const & account_a)
 {
 	chratos::mdb_val value;
@@ -1366,6 +1559,26 @@ void chratos::block_store::unchecked_clear (MDB_txn * transaction_a)
 {
 	auto status (mdb_drop (transaction_a, unchecked, 0));
 	assert (status == 0);
+	unchecked_entries = 0;
+}
+
+size_t chratos::block_store::unchecked_clear (MDB_txn * transaction_a, size_t max_a)
+{
+	size_t result (0);
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (transaction_a, unchecked, &cursor));
+	assert (status == 0);
+	MDB_val key;
+	MDB_val value;
+	for (auto status2 (mdb_cursor_get (cursor, &key, &value, MDB_FIRST)); status2 == 0 && result < max_a; status2 = mdb_cursor_get (cursor, &key, &value, MDB_FIRST))
+	{
+		auto status3 (mdb_cursor_del (cursor, 0));
+		assert (status3 == 0);
+		++result;
+	}
+	mdb_cursor_close (cursor);
+	unchecked_entries -= std::min<size_t> (result, unchecked_entries);
+	return result;
 }
 
 void chratos::block_store::unchecked_put (MDB_txn * transaction_a, chratos::block_hash const & hash_a, std::shared_ptr<chratos::block> const & block_a)
@@ -1441,14 +1654,75 @@ void chratos::block_store::unchecked_del (MDB_txn * transaction_a, chratos::bloc
 	chratos::mdb_val block (block_a);
 	auto status (mdb_del (transaction_a, unchecked, chratos::mdb_val (hash_a), block));
 	assert (status == 0 || status == MDB_NOTFOUND);
+	if (status == 0)
+	{
+		--unchecked_entries;
+	}
 }
 
 size_t chratos::block_store::unchecked_count (MDB_txn * transaction_a)
 {
-	MDB_stat unchecked_stats;
-	auto status (mdb_stat (transaction_a, unchecked, &unchecked_stats));
+	return unchecked_entries;
+}
+
+bool chratos::block_store::unchecked_page (MDB_txn * transaction_a, chratos::block_hash const & start_a, chratos::block_hash const & start_block_a, size_t count_a, chratos::block_type type_a, bool single_a, size_t scan_max_a, std::vector<std::pair<chratos::block_hash, std::shared_ptr<chratos::block>>> & result_a, chratos::block_hash & next_a, chratos::block_hash & next_block_a)
+{
+	auto result (false);
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (transaction_a, unchecked, &cursor));
 	assert (status == 0);
-	auto result (unchecked_stats.ms_entries);
+	chratos::mdb_val key (start_a);
+	chratos::mdb_val value;
+	auto status2 (single_a ? mdb_cursor_get (cursor, &key.value, &value.value, MDB_SET_KEY) : mdb_cursor_get (cursor, &key.value, &value.value, MDB_SET_RANGE));
+	if (status2 == 0 && !start_block_a.is_zero () && chratos::block_hash (key) == start_a)
+	{
+		// Duplicates are ordered by their serialized block rather than its hash, so the resume point is found by walking the key's duplicates
+		auto found (false);
+		auto status3 (status2);
+		while (status3 == 0 && !found)
+		{
+			std::shared_ptr<chratos::block> block (value);
+			found = block->hash () == start_block_a;
+			if (!found)
+			{
+				status3 = mdb_cursor_get (cursor, &key.value, &value.value, MDB_NEXT_DUP);
+			}
+		}
+		if (!found)
+		{
+			// Processed since the previous page, the key's remaining duplicates are read from the start
+			chratos::mdb_val key2 (start_a);
+			status2 = mdb_cursor_get (cursor, &key2.value, &value.value, MDB_SET_KEY);
+			key.value = key2.value;
+		}
+	}
+	boost::optional<chratos::block_hash> last;
+	size_t scanned (0);
+	while (status2 == 0 && !result)
+	{
+		chratos::block_hash current (key);
+		if (last && (result_a.size () >= count_a || scanned >= scan_max_a))
+		{
+			result = true;
+			next_a = current;
+			// Part way through a key's duplicates the page resumes at this block rather than the key's first one
+			next_block_a = current == *last ? std::shared_ptr<chratos::block> (value)->hash () : chratos::block_hash (0);
+		}
+		else
+		{
+			// Serialized blocks lead with their type, so filtered entries are skipped without deserialising
+			assert (value.size () > 0);
+			auto type (static_cast<chratos::block_type> (reinterpret_cast<uint8_t const *> (value.data ())[0]));
+			if (type_a == chratos::block_type::invalid || type == type_a)
+			{
+				result_a.push_back (std::make_pair (current, std::shared_ptr<chratos::block> (value)));
+			}
+			last = current;
+			++scanned;
+			status2 = mdb_cursor_get (cursor, &key.value, &value.value, single_a ? MDB_NEXT_DUP : MDB_NEXT);
+		}
+	}
+	mdb_cursor_close (cursor);
 	return result;
 }
 
@@ -1502,8 +1776,12 @@ void chratos::block_store::flush (MDB_txn * transaction_a)
 	for (auto & i : unchecked_cache_l)
 	{
 		mdb_val block (i.second);
-		auto status (mdb_put (transaction_a, unchecked, chratos::mdb_val (i.first), block, 0));
-		assert (status == 0);
+		auto status (mdb_put (transaction_a, unchecked, chratos::mdb_val (i.first), block, MDB_NODUPDATA));
+		assert (status == 0 || status == MDB_KEYEXIST);
+		if (status == 0)
+		{
+			++unchecked_entries;
+		}
 	}
 	for (auto i (sequence_cache_l.begin ()), n (sequence_cache_l.end ()); i != n; ++i)
 	{
@@ -1532,7 +1810,7 @@ std::shared_ptr<chratos::vote> chratos::block_store::vote_current (MDB_txn * tra
 	return result;
 }
 
-std::shared_ptr<chratos::vote> chratos::block_store::vote_generate (MDB_txn * transaction_a, chratos::account const & account_a, chratos::raw_key const & key_a, std::shared_ptr<chratos::block> block_a)
+std::shared_ptr<chratos::vote> chratos::block_store::vote_generate (MDB_txn * transaction_a, chratos::account const & account_a, chratos::expanded_key const & key_a, std::shared_ptr<chratos::block> block_a)
 {
 	std::lock_guard<std::mutex> lock (cache_mutex);
 	auto result (vote_current (transaction_a, account_a));
@@ -1542,7 +1820,7 @@ std::shared_ptr<chratos::vote> chratos::block_store::vote_generate (MDB_txn * tr
 	return result;
 }
 
-std::shared_ptr<chratos::vote> chratos::block_store::vote_generate (MDB_txn * transaction_a, chratos::account const & account_a, chratos::raw_key const & key_a, std::vector<chratos::block_hash> blocks_a)
+std::shared_ptr<chratos::vote> chratos::block_store::vote_generate (MDB_txn * transaction_a, chratos::account const & account_a, chratos::expanded_key const & key_a, std::vector<chratos::block_hash> blocks_a)
 {
 	std::lock_guard<std::mutex> lock (cache_mutex);
 	auto result (vote_current (transaction_a, account_a));
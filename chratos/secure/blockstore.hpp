@@ -153,7 +153,10 @@ public:
 	std::unique_ptr<chratos::block> block_random (MDB_txn *);
 	void block_del (MDB_txn *, chratos::block_hash const &);
 	bool block_exists (MDB_txn *, chratos::block_hash const &);
+	// Served from the cached table counts, no database access
 	chratos::block_counts block_count (MDB_txn *);
+	// Counts read with mdb_stat
+	chratos::block_counts block_count_stat (MDB_txn *);
 	bool root_exists (MDB_txn *, chratos::uint256_union const &);
 
 	void frontier_put (MDB_txn *, chratos::block_hash const &, chratos::account const &);
@@ -165,6 +168,12 @@ public:
 	void account_del (MDB_txn *, chratos::account const &);
 	bool account_exists (MDB_txn *, chratos::account const &);
 	size_t account_count (MDB_txn *);
+	size_t account_count_stat (MDB_txn *);
+	// Reset the cached table counts from mdb_stat
+	void counts_seed (MDB_txn *);
+	// Compare the cached table counts against mdb_stat and reseed them, returns true if they had drifted
+	// Needs a write transaction so no other writer can be midway through updating them
+	bool counts_verify (MDB_txn *);
 	chratos::store_iterator<chratos::account, chratos::account_info> latest_v0_begin (MDB_txn *, chratos::account const &);
 	chratos::store_iterator<chratos::account, chratos::account_info> latest_v0_begin (MDB_txn *);
 	chratos::store_iterator<chratos::account, chratos::account_info> latest_v0_end ();
@@ -203,6 +212,11 @@ public:
 	chratos::epoch block_version (MDB_txn *, chratos::block_hash const &);
 	static size_t const block_info_max = 32;
 
+	void confirmation_height_put (MDB_txn *, chratos::account const &, chratos::confirmation_height_info const &);
+	// Returns true if nothing is confirmed for the account yet
+	bool confirmation_height_get (MDB_txn *, chratos::account const &, chratos::confirmation_height_info &);
+	void confirmation_height_del (MDB_txn *, chratos::account const &);
+
 	chratos::uint128_t representation_get (MDB_txn *, chratos::account const &);
 	void representation_put (MDB_txn *, chratos::account const &, chratos::uint128_t const &);
 	void representation_add (MDB_txn *, chratos::account const &, chratos::uint128_t const &);
@@ -210,6 +224,8 @@ public:
 	chratos::store_iterator<chratos::account, chratos::uint128_union> representation_end ();
 
 	void unchecked_clear (MDB_txn *);
+	// Delete at most max_a entries from the front of the table, returns the number deleted
+	size_t unchecked_clear (MDB_txn *, size_t max_a);
 	void unchecked_put (MDB_txn *, chratos::block_hash const &, std::shared_ptr<chratos::block> const &);
 	std::vector<std::shared_ptr<chratos::block>> unchecked_get (MDB_txn *, chratos::block_hash const &);
 	void unchecked_del (MDB_txn *, chratos::block_hash const &, std::shared_ptr<chratos::block>);
@@ -217,6 +233,13 @@ public:
 	chratos::store_iterator<chratos::block_hash, std::shared_ptr<chratos::block>> unchecked_begin (MDB_txn *, chratos::block_hash const &);
 	chratos::store_iterator<chratos::block_hash, std::shared_ptr<chratos::block>> unchecked_end ();
 	size_t unchecked_count (MDB_txn *);
+	/**
+	 * Read up to count_a unchecked entries starting at the dependency hash start_a, only deserialising blocks of type_a unless it is invalid.
+	 * With single_a only entries keyed by start_a are read. A non-zero start_block_a resumes inside start_a's duplicates at that block.
+	 * At most scan_max_a entries are visited, returns true and sets next_a and next_block_a to resume from if entries remain,
+	 * next_block_a is zero when the page ended on a key boundary.
+	 */
+	bool unchecked_page (MDB_txn *, chratos::block_hash const & start_a, chratos::block_hash const & start_block_a, size_t count_a, chratos::block_type type_a, bool single_a, size_t scan_max_a, std::vector<std::pair<chratos::block_hash, std::shared_ptr<chratos::block>>> & result_a, chratos::block_hash & next_a, chratos::block_hash & next_block_a);
 	std::unordered_multimap<chratos::block_hash, std::shared_ptr<chratos::block>> unchecked_cache;
 
 	void checksum_put (MDB_txn *, uint64_t, uint8_t, chratos::checksum const &);
@@ -226,8 +249,8 @@ public:
 	// Return latest vote for an account from store
 	std::shared_ptr<chratos::vote> vote_get (MDB_txn *, chratos::account const &);
 	// Populate vote with the next sequence number
-	std::shared_ptr<chratos::vote> vote_generate (MDB_txn *, chratos::account const &, chratos::raw_key const &, std::shared_ptr<chratos::block>);
-	std::shared_ptr<chratos::vote> vote_generate (MDB_txn *, chratos::account const &, chratos::raw_key const &, std::vector<chratos::block_hash>);
+	std::shared_ptr<chratos::vote> vote_generate (MDB_txn *, chratos::account const &, chratos::expanded_key const &, std::shared_ptr<chratos::block>);
+	std::shared_ptr<chratos::vote> vote_generate (MDB_txn *, chratos::account const &, chratos::expanded_key const &, std::vector<chratos::block_hash>);
 	// Return either vote or the stored vote with a higher sequence number
 	std::shared_ptr<chratos::vote> vote_max (MDB_txn *, std::shared_ptr<chratos::vote>);
 	// Return latest vote for an account considering the vote cache
@@ -350,6 +373,12 @@ public:
 	 */
 	MDB_dbi blocks_info;
 
+	/**
+	 * Confirmed frontier of each account.
+	 * chratos::account -> uint64_t, chratos::block_hash
+	 */
+	MDB_dbi confirmation_height;
+
 	/**
 	 * Representative weights.
 	 * chratos::account -> chratos::uint128_t
@@ -380,7 +409,19 @@ public:
 	 */
 	MDB_dbi meta;
 
+	/**
+	 * Cached entry counts of the block and account tables, maintained by the put and delete paths
+	 */
+	std::atomic<size_t> state_v0_count;
+	std::atomic<size_t> state_v1_count;
+	std::atomic<size_t> dividend_count;
+	std::atomic<size_t> claim_count;
+	std::atomic<size_t> accounts_v0_count;
+	std::atomic<size_t> accounts_v1_count;
+	std::atomic<size_t> unchecked_entries;
+
 private:
+	std::atomic<size_t> * table_count (MDB_dbi);
 	MDB_dbi block_database (chratos::block_type, chratos::epoch);
 	template <typename T>
 	std::unique_ptr<chratos::block> block_random (MDB_txn *, MDB_dbi);
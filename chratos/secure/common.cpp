@@ -69,6 +69,7 @@ public:
 	ledger_constants () :
 	zero_key ("0"),
 	test_genesis_key (test_private_key_data),
+	test_dividend_key (test_dividend_private_key_data),
 	chratos_test_account (test_public_key_data),
 	chratos_beta_account (beta_public_key_data),
 	chratos_live_account (live_public_key_data),
@@ -92,6 +93,7 @@ public:
 	}
 	chratos::keypair zero_key;
 	chratos::keypair test_genesis_key;
+	chratos::keypair test_dividend_key;
 	chratos::account chratos_test_account;
 	chratos::account chratos_beta_account;
 	chratos::account chratos_live_account;
@@ -119,6 +121,7 @@ size_t constexpr chratos::claim_block::size;
 
 chratos::keypair const & chratos::zero_key (globals.zero_key);
 chratos::keypair const & chratos::test_genesis_key (globals.test_genesis_key);
+chratos::keypair const & chratos::test_dividend_key (globals.test_dividend_key);
 chratos::account const & chratos::chratos_test_account (globals.chratos_test_account);
 chratos::account const & chratos::chratos_beta_account (globals.chratos_beta_account);
 chratos::account const & chratos::chratos_live_account (globals.chratos_live_account);
@@ -436,6 +439,39 @@ bool chratos::block_info::operator== (chratos::block_info const & other_a) const
 	return account == other_a.account && balance == other_a.balance;
 }
 
+chratos::confirmation_height_info::confirmation_height_info () :
+height (0),
+frontier (0)
+{
+}
+
+chratos::confirmation_height_info::confirmation_height_info (uint64_t height_a, chratos::block_hash const & frontier_a) :
+height (height_a),
+frontier (frontier_a)
+{
+}
+
+void chratos::confirmation_height_info::serialize (chratos::stream & stream_a) const
+{
+	chratos::write (stream_a, height);
+	chratos::write (stream_a, frontier.bytes);
+}
+
+bool chratos::confirmation_height_info::deserialize (chratos::stream & stream_a)
+{
+	auto error (chratos::read (stream_a, height));
+	if (!error)
+	{
+		error = chratos::read (stream_a, frontier.bytes);
+	}
+	return error;
+}
+
+bool chratos::confirmation_height_info::operator== (chratos::confirmation_height_info const & other_a) const
+{
+	return height == other_a.height && frontier == other_a.frontier;
+}
+
 bool chratos::vote::operator== (chratos::vote const & other_a) const
 {
 	auto blocks_equal (true);
@@ -726,6 +762,26 @@ account (account_a)
 	signature = chratos::sign_message (prv_a, account_a, hash ());
 }
 
+chratos::vote::vote (chratos::account const & account_a, chratos::expanded_key const & prv_a, uint64_t sequence_a, std::shared_ptr<chratos::block> block_a) :
+sequence (sequence_a),
+blocks (1, block_a),
+account (account_a),
+signature (chratos::sign_message (prv_a, account_a, hash ()))
+{
+}
+
+chratos::vote::vote (chratos::account const & account_a, chratos::expanded_key const & prv_a, uint64_t sequence_a, std::vector<chratos::block_hash> blocks_a) :
+sequence (sequence_a),
+account (account_a)
+{
+	assert (blocks_a.size () > 0);
+	for (auto hash : blocks_a)
+	{
+		blocks.push_back (hash);
+	}
+	signature = chratos::sign_message (prv_a, account_a, hash ());
+}
+
 std::string chratos::vote::hashes_string () const
 {
 	std::string result;
@@ -147,6 +147,21 @@ public:
 	chratos::account account;
 	chratos::amount balance;
 };
+/**
+ * Confirmed frontier of an account chain, every block from the open block up to and including it is cemented
+ */
+class confirmation_height_info
+{
+public:
+	confirmation_height_info ();
+	confirmation_height_info (uint64_t, chratos::block_hash const &);
+	void serialize (chratos::stream &) const;
+	bool deserialize (chratos::stream &);
+	bool operator== (chratos::confirmation_height_info const &) const;
+	/** Number of cemented blocks, 0 if none of the account's blocks are confirmed */
+	uint64_t height;
+	chratos::block_hash frontier;
+};
 class block_counts
 {
 public:
@@ -173,6 +188,8 @@ public:
 	vote (bool &, chratos::stream &, chratos::block_type);
 	vote (chratos::account const &, chratos::raw_key const &, uint64_t, std::shared_ptr<chratos::block>);
 	vote (chratos::account const &, chratos::raw_key const &, uint64_t, std::vector<chratos::block_hash>);
+	vote (chratos::account const &, chratos::expanded_key const &, uint64_t, std::shared_ptr<chratos::block>);
+	vote (chratos::account const &, chratos::expanded_key const &, uint64_t, std::vector<chratos::block_hash>);
 	std::string hashes_string () const;
 	chratos::uint256_union hash () const;
 	bool operator== (chratos::vote const &) const;
@@ -219,7 +236,8 @@ enum class process_result
   dividend_too_small, // Dividend amount is not large enough
   incorrect_dividend, // Incorrect dividend being sent
   dividend_fork, // Malicious fork based on previous dividend
-  invalid_dividend_account
+  invalid_dividend_account,
+  insufficient_work // Work doesn't meet the threshold, the block was never queued for processing
 };
 class process_return
 {
@@ -238,6 +256,7 @@ enum class tally_result
 };
 extern chratos::keypair const & zero_key;
 extern chratos::keypair const & test_genesis_key;
+extern chratos::keypair const & test_dividend_key;
 extern chratos::account const & chratos_test_account;
 extern chratos::account const & chratos_beta_account;
 extern chratos::account const & chratos_live_account;
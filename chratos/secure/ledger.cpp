@@ -5,6 +5,10 @@
 #include <boost/multiprecision/cpp_bin_float.hpp>
 #include <boost/multiprecision/cpp_dec_float.hpp>
 
+#include <unordered_set>
+
+size_t constexpr chratos::ledger::confirmation_walk_max;
+
 namespace
 {
 /**
@@ -76,6 +80,19 @@ public:
     {
       ledger.stats.inc (chratos::stat::type::rollback, chratos::stat::detail::open);
     }
+    chratos::confirmation_height_info confirmed;
+    if (!ledger.store.confirmation_height_get (transaction, block_a.hashables.account, confirmed) && confirmed.frontier == hash)
+    {
+      // Keep the confirmed frontier on the chain if a cemented block is ever rolled back
+      if (previous != nullptr)
+      {
+        ledger.store.confirmation_height_put (transaction, block_a.hashables.account, chratos::confirmation_height_info (confirmed.height - 1, block_a.hashables.previous));
+      }
+      else
+      {
+        ledger.store.confirmation_height_del (transaction, block_a.hashables.account);
+      }
+    }
     ledger.store.block_del (transaction, hash);
   } 
   void dividend_block (chratos::dividend_block const & block_a) override
@@ -505,6 +522,16 @@ bool chratos::shared_ptr_block_hash::operator() (std::shared_ptr<chratos::block>
   return lhs->hash () == rhs->hash ();
 }
 
+chratos::confirmation_job::confirmation_job (chratos::block_hash const & hash_a) :
+stack (1, target{ hash_a, 0, false })
+{
+}
+
+bool chratos::confirmation_job::done () const
+{
+  return stack.empty ();
+}
+
 chratos::ledger::ledger (chratos::block_store & store_a, chratos::stat & stat_a, chratos::uint256_union const & epoch_link_a, chratos::account const & epoch_signer_a) :
 store (store_a),
 stats (stat_a),
@@ -687,8 +714,6 @@ chratos::amount chratos::ledger::amount_for_dividend (MDB_txn * transaction_a, c
   chratos::amount result (0);
   chratos::account_info account_info;
   std::shared_ptr<chratos::block> block_l = store.block_get(transaction_a, dividend_a);
-  auto dividend_hash (block_l->dividend ());
-  auto previous (store.block_get(transaction_a, block_l->previous ()));
   chratos::dividend_block const * dividend_block (dynamic_cast<chratos::dividend_block const *> (block_l.get ()));
 
   assert (dividend_block != nullptr);
@@ -705,19 +730,7 @@ chratos::amount chratos::ledger::amount_for_dividend (MDB_txn * transaction_a, c
       }
 
       if (front) {
-        chratos::amount genesis_supply (std::numeric_limits<chratos::uint128_t>::max ());
-        chratos::amount burned_amount (burn_account_balance (transaction_a, dividend_a));
-        chratos::amount balance_at_dividend (balance (transaction_a, front->hash ()));
-        chratos::amount dividend_amount (amount (transaction_a, block_l->hash ()));
-        chratos::amount total_supply (genesis_supply.number () - burned_amount.number ());
-        boost::multiprecision::cpp_bin_float_100 balance_f (balance_at_dividend.number ());
-        boost::multiprecision::cpp_bin_float_100 daf (dividend_amount.number ());
-        boost::multiprecision::cpp_bin_float_100 tsf (total_supply.number ());
-        boost::multiprecision::cpp_bin_float_100 total_f (tsf - daf);
-        boost::multiprecision::cpp_bin_float_100 proportion (balance_f / total_f);
-        boost::multiprecision::cpp_bin_float_100 reward (proportion * daf);
-
-        result = chratos::amount (static_cast<uint128_t> (reward));
+        result = dividend_reward (transaction_a, dividend_a, balance (transaction_a, front->hash ()));
       }
     }
   }
@@ -725,6 +738,22 @@ chratos::amount chratos::ledger::amount_for_dividend (MDB_txn * transaction_a, c
   return result;
 }
 
+chratos::amount chratos::ledger::dividend_reward (MDB_txn * transaction_a, chratos::block_hash const & dividend_a, chratos::amount const & balance_a)
+{
+  chratos::amount genesis_supply (std::numeric_limits<chratos::uint128_t>::max ());
+  chratos::amount burned_amount (burn_account_balance (transaction_a, dividend_a));
+  chratos::amount dividend_amount (amount (transaction_a, dividend_a));
+  chratos::amount total_supply (genesis_supply.number () - burned_amount.number ());
+  boost::multiprecision::cpp_bin_float_100 balance_f (balance_a.number ());
+  boost::multiprecision::cpp_bin_float_100 daf (dividend_amount.number ());
+  boost::multiprecision::cpp_bin_float_100 tsf (total_supply.number ());
+  boost::multiprecision::cpp_bin_float_100 total_f (tsf - daf);
+  boost::multiprecision::cpp_bin_float_100 proportion (balance_f / total_f);
+  boost::multiprecision::cpp_bin_float_100 reward (proportion * daf);
+
+  return chratos::amount (static_cast<uint128_t> (reward));
+}
+
 std::vector<chratos::block_hash> chratos::ledger::unclaimed_for_account (MDB_txn * transaction_a, chratos::account const & account_a)
 {
   std::vector<chratos::block_hash> result;
@@ -878,19 +907,402 @@ chratos::uint128_t chratos::ledger::weight (MDB_txn * transaction_a, chratos::ac
   return store.representation_get (transaction_a, account_a);
 }
 
+namespace
+{
+chratos::account block_account (chratos::block const & block_a)
+{
+  chratos::account result (0);
+  if (auto state = dynamic_cast<chratos::state_block const *> (&block_a))
+  {
+    result = state->hashables.account;
+  }
+  else if (auto dividend = dynamic_cast<chratos::dividend_block const *> (&block_a))
+  {
+    result = dividend->hashables.account;
+  }
+  else if (auto claim = dynamic_cast<chratos::claim_block const *> (&block_a))
+  {
+    result = claim->hashables.account;
+  }
+  return result;
+}
+
+/**
+ * Rolls back a block along with every block depending on it, across accounts, in one pass
+ * The blocks are planned up front so balance, weight and pending changes are aggregated and each account is rewritten once
+ */
+class bulk_rollback
+{
+public:
+  bulk_rollback (MDB_txn * transaction_a, chratos::ledger & ledger_a) :
+  transaction (transaction_a),
+  ledger (ledger_a)
+  {
+  }
+  // Returns true if the set couldn't be planned, i.e. a dividend or claim block would have to be rolled back
+  bool plan (chratos::block_hash const & hash_a)
+  {
+    std::shared_ptr<chratos::block> block (ledger.store.block_get (transaction, hash_a));
+    assert (block != nullptr);
+    auto account (block_account (*block));
+    auto error (account.is_zero ());
+    if (!error && planned.find (hash_a) == planned.end ())
+    {
+      error = extend (account, [&hash_a](chratos::state_block const & block_a) { return block_a.hash () == hash_a; });
+    }
+    while (!error && !unexamined.empty ())
+    {
+      auto block_l (unexamined.front ());
+      unexamined.pop_front ();
+      auto hash (block_l->hash ());
+      if (is_send (*block_l) && !ledger.store.pending_exists (transaction, chratos::pending_key (block_l->hashables.link, hash)))
+      {
+        // The send has been received, the receiving block has to go as well
+        auto destination (block_l->hashables.link);
+        auto receives ([this, &hash](chratos::state_block const & block_a) { return block_a.hashables.link == hash && !is_send (block_a); });
+        auto & chain (chains[destination]);
+        auto existing (std::find_if (chain.begin (), chain.end (), [&receives](std::shared_ptr<chratos::state_block> const & block_a) { return receives (*block_a); }));
+        if (existing == chain.end ())
+        {
+          error = extend (destination, receives);
+        }
+      }
+    }
+    return error;
+  }
+  void apply ()
+  {
+    // Weight deltas by representative account, wrapping arithmetic like representation_add
+    std::unordered_map<chratos::account, chratos::uint128_t> weights;
+    for (auto & i : chains)
+    {
+      auto & account (i.first);
+      auto & blocks (i.second);
+      if (!blocks.empty ())
+      {
+        auto head (blocks.front ());
+        auto lowest (blocks.back ());
+        auto previous (lowest->hashables.previous);
+        chratos::account_info info;
+        auto error (ledger.store.account_get (transaction, account, info));
+        assert (!error);
+        // The chain's weight moves from the head's representative back to the one in force before the lowest block
+        weights[head->hashables.representative] -= head->hashables.balance.number ();
+        chratos::block_hash representative (0);
+        chratos::uint128_t balance (0);
+        if (!previous.is_zero ())
+        {
+          representative = ledger.representative (transaction, previous);
+          balance = ledger.balance (transaction, previous);
+          auto representative_block (ledger.store.block_get (transaction, representative));
+          assert (representative_block != nullptr);
+          weights[representative_block->representative ()] += balance;
+        }
+        for (size_t j (0), n (blocks.size ()); j < n; ++j)
+        {
+          auto & block (blocks[j]);
+          auto hash (block->hash ());
+          auto previous_balance (j + 1 < n ? blocks[j + 1]->hashables.balance.number () : balance);
+          if (block->hashables.balance.number () < previous_balance)
+          {
+            chratos::pending_key key (block->hashables.link, hash);
+            if (ledger.store.pending_exists (transaction, key))
+            {
+              ledger.store.pending_del (transaction, key);
+            }
+            ledger.stats.inc (chratos::stat::type::rollback, chratos::stat::detail::send);
+          }
+          else if (!block->hashables.link.is_zero () && block->hashables.link != ledger.epoch_link)
+          {
+            // Sources rolled back in the same pass would only have their pending entry deleted again
+            if (planned.find (block->hashables.link) == planned.end ())
+            {
+              std::shared_ptr<chratos::block> source (ledger.store.block_get (transaction, block->hashables.link));
+              assert (source != nullptr);
+              auto source_version (ledger.store.block_version (transaction, block->hashables.link));
+              chratos::pending_info pending_info (block_account (*source), block->hashables.balance.number () - previous_balance, block->hashables.dividend, source_version);
+              ledger.store.pending_put (transaction, chratos::pending_key (account, block->hashables.link), pending_info);
+            }
+            ledger.stats.inc (chratos::stat::type::rollback, chratos::stat::detail::receive);
+          }
+        }
+        auto previous_version (ledger.store.block_version (transaction, previous));
+        ledger.change_latest (transaction, account, previous, representative, lowest->hashables.dividend, balance, info.block_count - blocks.size (), false, previous_version);
+        auto previous_block (ledger.store.block_get (transaction, previous));
+        if (previous_block != nullptr)
+        {
+          ledger.store.block_successor_clear (transaction, previous);
+          if (previous_block->type () < chratos::block_type::state)
+          {
+            ledger.store.frontier_put (transaction, previous, account);
+          }
+        }
+        else
+        {
+          ledger.stats.inc (chratos::stat::type::rollback, chratos::stat::detail::open);
+        }
+        chratos::confirmation_height_info confirmed;
+        if (!ledger.store.confirmation_height_get (transaction, account, confirmed) && planned.find (confirmed.frontier) != planned.end ())
+        {
+          // Keep the confirmed frontier on the chain if cemented blocks are ever rolled back
+          if (previous_block != nullptr)
+          {
+            ledger.store.confirmation_height_put (transaction, account, chratos::confirmation_height_info (info.block_count - blocks.size (), previous));
+          }
+          else
+          {
+            ledger.store.confirmation_height_del (transaction, account);
+          }
+        }
+        for (auto & block : blocks)
+        {
+          ledger.store.block_del (transaction, block->hash ());
+        }
+      }
+    }
+    for (auto & i : weights)
+    {
+      if (!i.second.is_zero ())
+      {
+        ledger.store.representation_put (transaction, i.first, ledger.store.representation_get (transaction, i.first) + i.second);
+      }
+    }
+  }
+
+private:
+  bool is_send (chratos::state_block const & block_a)
+  {
+    return ledger.is_send (transaction, block_a);
+  }
+  // Plan more of the account's chain, from its head or below what's already planned, until a block matching the predicate is included
+  template <typename T>
+  bool extend (chratos::account const & account_a, T predicate_a)
+  {
+    auto & chain (chains[account_a]);
+    chratos::block_hash next (0);
+    if (chain.empty ())
+    {
+      chratos::account_info info;
+      if (!ledger.store.account_get (transaction, account_a, info))
+      {
+        next = info.head;
+      }
+    }
+    else
+    {
+      next = chain.back ()->hashables.previous;
+    }
+    auto error (false);
+    auto found (false);
+    while (!error && !found)
+    {
+      std::shared_ptr<chratos::block> block (next.is_zero () ? nullptr : ledger.store.block_get (transaction, next));
+      auto state (std::dynamic_pointer_cast<chratos::state_block> (block));
+      error = state == nullptr;
+      if (!error)
+      {
+        chain.push_back (state);
+        planned.insert (next);
+        unexamined.push_back (state);
+        found = predicate_a (*state);
+        next = state->hashables.previous;
+      }
+    }
+    return error;
+  }
+  MDB_txn * transaction;
+  chratos::ledger & ledger;
+  // Blocks to roll back for each account, head first
+  std::unordered_map<chratos::account, std::vector<std::shared_ptr<chratos::state_block>>> chains;
+  std::unordered_set<chratos::block_hash> planned;
+  std::deque<std::shared_ptr<chratos::state_block>> unexamined;
+};
+}
+
 // Rollback blocks until `block_a' doesn't exist
 void chratos::ledger::rollback (MDB_txn * transaction_a, chratos::block_hash const & block_a)
 {
   assert (store.block_exists (transaction_a, block_a));
-  auto account_l (account (transaction_a, block_a));
-  rollback_visitor rollback (transaction_a, *this);
-  chratos::account_info info;
-  while (store.block_exists (transaction_a, block_a))
+  bulk_rollback bulk (transaction_a, *this);
+  if (!bulk.plan (block_a))
+  {
+    bulk.apply ();
+  }
+  else
+  {
+    // Fall back to undoing one block at a time
+    auto account_l (account (transaction_a, block_a));
+    rollback_visitor rollback (transaction_a, *this);
+    chratos::account_info info;
+    while (store.block_exists (transaction_a, block_a))
+    {
+      auto latest_error (store.account_get (transaction_a, account_l, info));
+      assert (!latest_error);
+      auto block (store.block_get (transaction_a, info.head));
+      block->visit (rollback);
+    }
+  }
+}
+
+uint64_t chratos::ledger::confirmation_height (MDB_txn * transaction_a, chratos::account const & account_a)
+{
+  chratos::confirmation_height_info confirmed;
+  store.confirmation_height_get (transaction_a, account_a, confirmed);
+  return confirmed.height;
+}
+
+chratos::confirmation_status chratos::ledger::block_confirmed (MDB_txn * transaction_a, chratos::block_hash const & hash_a)
+{
+  auto result (chratos::confirmation_status::unconfirmed);
+  std::shared_ptr<chratos::block> block (store.block_get (transaction_a, hash_a));
+  if (block != nullptr)
+  {
+    auto account_l (block_account (*block));
+    chratos::confirmation_height_info confirmed;
+    if (!store.confirmation_height_get (transaction_a, account_l, confirmed) && confirmed.height != 0)
+    {
+      chratos::account_info info;
+      auto error (store.account_get (transaction_a, account_l, info));
+      assert (!error);
+      // Only the top limit blocks of the chain are unconfirmed, so walking back from an unconfirmed block meets the frontier within that many steps
+      auto limit (info.block_count - std::min (info.block_count, confirmed.height));
+      auto done (false);
+      size_t walked (0);
+      while (!done)
+      {
+        if (block->hash () == confirmed.frontier)
+        {
+          result = walked == 0 ? chratos::confirmation_status::confirmed : chratos::confirmation_status::unconfirmed;
+          done = true;
+        }
+        else if (walked == limit)
+        {
+          result = chratos::confirmation_status::confirmed;
+          done = true;
+        }
+        else if (walked == confirmation_walk_max)
+        {
+          // Can't tell without a long walk
+          result = chratos::confirmation_status::unknown;
+          done = true;
+        }
+        else
+        {
+          ++walked;
+          auto previous (block->previous ());
+          if (previous.is_zero ())
+          {
+            // Reached the open block without passing the confirmed frontier
+            result = chratos::confirmation_status::confirmed;
+            done = true;
+          }
+          else
+          {
+            block = store.block_get (transaction_a, previous);
+            assert (block != nullptr);
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<chratos::block_hash> chratos::ledger::confirmation_dependencies (MDB_txn * transaction_a, chratos::block const & block_a)
+{
+  std::vector<chratos::block_hash> result;
+  if (!block_a.dividend ().is_zero ())
+  {
+    result.push_back (block_a.dividend ());
+  }
+  if (auto state = dynamic_cast<chratos::state_block const *> (&block_a))
+  {
+    if (!state->hashables.link.is_zero () && state->hashables.link != epoch_link && !is_send (transaction_a, *state))
+    {
+      result.push_back (state->hashables.link);
+    }
+  }
+  return result;
+}
+
+void chratos::ledger::confirm (MDB_txn * transaction_a, chratos::confirmation_job & job_a, size_t max_a)
+{
+  size_t budget (max_a);
+  while (!job_a.stack.empty () && budget > 0)
   {
-    auto latest_error (store.account_get (transaction_a, account_l, info));
-    assert (!latest_error);
-    auto block (store.block_get (transaction_a, info.head));
-    block->visit (rollback);
+    auto & target (job_a.stack.back ());
+    std::shared_ptr<chratos::block> block (store.block_get (transaction_a, target.hash));
+    if (block == nullptr)
+    {
+      // Rolled back since it was queued, nothing to cement
+      job_a.stack.pop_back ();
+      continue;
+    }
+    auto account_l (block_account (*block));
+    chratos::confirmation_height_info confirmed;
+    store.confirmation_height_get (transaction_a, account_l, confirmed);
+    chratos::account_info info;
+    auto error (store.account_get (transaction_a, account_l, info));
+    assert (!error);
+    // First block above the confirmed frontier
+    auto next (confirmed.height == 0 ? info.open_block : store.block_successor (transaction_a, confirmed.frontier));
+    if (confirmed.height != 0 && confirmed.frontier == target.hash)
+    {
+      job_a.cemented.insert (target.hash);
+      job_a.stack.pop_back ();
+    }
+    else if (!target.located)
+    {
+      // Scan forward from the frontier before cementing anything, a target that isn't found is already at or below it
+      auto hash (!target.cursor.is_zero () && store.block_exists (transaction_a, target.cursor) ? target.cursor : next);
+      while (!hash.is_zero () && hash != target.hash && budget > 0)
+      {
+        hash = store.block_successor (transaction_a, hash);
+        --budget;
+      }
+      if (hash.is_zero ())
+      {
+        job_a.cemented.insert (target.hash);
+        job_a.stack.pop_back ();
+      }
+      else if (hash == target.hash)
+      {
+        target.located = true;
+      }
+      else
+      {
+        target.cursor = hash;
+      }
+    }
+    else
+    {
+      assert (!next.is_zero ());
+      std::shared_ptr<chratos::block> next_block (store.block_get (transaction_a, next));
+      assert (next_block != nullptr);
+      --budget;
+      // Blocks this one receives or claims from have to be cemented first
+      chratos::block_hash pending_dependency (0);
+      for (auto & dependency : confirmation_dependencies (transaction_a, *next_block))
+      {
+        if (pending_dependency.is_zero () && job_a.cemented.find (dependency) == job_a.cemented.end () && store.block_exists (transaction_a, dependency) && block_confirmed (transaction_a, dependency) != chratos::confirmation_status::confirmed)
+        {
+          pending_dependency = dependency;
+        }
+      }
+      if (pending_dependency.is_zero ())
+      {
+        store.confirmation_height_put (transaction_a, account_l, chratos::confirmation_height_info (confirmed.height + 1, next));
+        if (next == target.hash)
+        {
+          job_a.cemented.insert (target.hash);
+          job_a.stack.pop_back ();
+        }
+      }
+      else
+      {
+        job_a.stack.push_back (chratos::confirmation_job::target{ pending_dependency, 0, false });
+      }
+    }
   }
 }
 
@@ -2,6 +2,8 @@
 
 #include <chratos/secure/common.hpp>
 
+#include <unordered_set>
+
 struct MDB_txn;
 namespace chratos
 {
@@ -15,6 +17,33 @@ public:
 	bool operator() (std::shared_ptr<chratos::block> const &, std::shared_ptr<chratos::block> const &) const;
 };
 using tally_t = std::map<chratos::uint128_t, std::shared_ptr<chratos::block>, std::greater<chratos::uint128_t>>;
+enum class confirmation_status
+{
+	unconfirmed,
+	confirmed,
+	// The walk back to the confirmed frontier was cut off before it could tell
+	unknown
+};
+// Cementing a block along with everything it depends on, worked through in bounded steps so it can span several write transactions
+class confirmation_job
+{
+public:
+	confirmation_job (chratos::block_hash const &);
+	bool done () const;
+	class target
+	{
+	public:
+		chratos::block_hash hash;
+		// Where the forward scan for the target stopped when it ran out of budget
+		chratos::block_hash cursor;
+		// The target is known to be above its account's confirmed frontier
+		bool located;
+	};
+	// Blocks still to be cemented, the dependency being worked on is at the back
+	std::vector<target> stack;
+	// Targets finished by this job, so dependencies aren't revisited when block_confirmed can't tell cheaply
+	std::unordered_set<chratos::block_hash> cemented;
+};
 class ledger
 {
 public:
@@ -41,6 +70,8 @@ public:
   bool has_outstanding_pendings_for_dividend (MDB_txn *, chratos::block_hash const &, chratos::account const &);
   bool dividends_are_ordered (MDB_txn *, chratos::block_hash const &, chratos::block_hash const &);
   chratos::amount amount_for_dividend (MDB_txn *, chratos::block_hash const &, chratos::account const &);
+  // Share of a dividend paid to an account that held balance_a when it was issued
+  chratos::amount dividend_reward (MDB_txn *, chratos::block_hash const &, chratos::amount const &);
   std::vector<chratos::block_hash> unclaimed_for_account (MDB_txn *, chratos::account const &);
   chratos::amount burn_account_balance (MDB_txn *, chratos::block_hash const &);
   std::vector<std::shared_ptr<chratos::block>> dividend_claim_blocks (MDB_txn *, chratos::account const &);
@@ -49,12 +80,23 @@ public:
 	chratos::block_hash block_source (MDB_txn *, chratos::block const &);
 	chratos::process_return process (MDB_txn *, chratos::block const &);
 	void rollback (MDB_txn *, chratos::block_hash const &);
+	// Number of cemented blocks at the start of the account's chain
+	uint64_t confirmation_height (MDB_txn *, chratos::account const &);
+	// Whether the block is at or below its account's confirmation height
+	// Walks at most confirmation_walk_max blocks, if the answer is further away than that it's unknown
+	chratos::confirmation_status block_confirmed (MDB_txn *, chratos::block_hash const &);
+	// Scan or cement at most max_a blocks of the job, oldest block first, requires a write transaction
+	// Call again in a new transaction until the job is done
+	void confirm (MDB_txn *, chratos::confirmation_job &, size_t);
+	// Blocks that have to be cemented before this one, its dividend and the source it receives or claims from
+	std::vector<chratos::block_hash> confirmation_dependencies (MDB_txn *, chratos::block const &);
 	void change_latest (MDB_txn *, chratos::account const &, chratos::block_hash const &, chratos::account const &, chratos::block_hash const &, chratos::uint128_union const &, uint64_t, bool = false, chratos::epoch = chratos::epoch::epoch_0);
 	void checksum_update (MDB_txn *, chratos::block_hash const &);
 	chratos::checksum checksum (MDB_txn *, chratos::account const &, chratos::account const &);
 	void dump_account_chain (chratos::account const &);
 	bool could_fit (MDB_txn *, chratos::block const &);
 	static chratos::uint128_t const unit;
+	static size_t constexpr confirmation_walk_max = 1024;
 	chratos::block_store & store;
 	chratos::stat & stats;
 	std::unordered_map<chratos::account, chratos::uint128_t> bootstrap_weights;
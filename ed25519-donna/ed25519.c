@@ -55,14 +55,16 @@ ED25519_FN(ed25519_publickey) (const ed25519_secret_key sk, ed25519_public_key p
 }
 
 
-void
-ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS) {
+/*
+	Signs with an already expanded secret, a is the scalar from extsk[0..31]
+*/
+
+static void
+ed25519_sign_extsk(const unsigned char *m, size_t mlen, const hash_512bits extsk, const bignum256modm a, const ed25519_public_key pk, ed25519_signature RS) {
 	ed25519_hash_context ctx;
-	bignum256modm r, S, a;
+	bignum256modm r, S;
 	ge25519 ALIGN(16) R;
-	hash_512bits extsk, hashr, hram;
-
-	ed25519_extsk(extsk, sk);
+	hash_512bits hashr, hram;
 
 	/* r = H(aExt[32..64], m) */
 	ed25519_hash_init(&ctx);
@@ -80,7 +82,6 @@ ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_sec
 	expand256_modm(S, hram, 64);
 
 	/* S = H(R,A,m)a */
-	expand256_modm(a, extsk, 32);
 	mul256_modm(S, S, a);
 
 	/* S = (r + H(R,A,m)a) */
@@ -90,6 +91,49 @@ ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_sec
 	contract256_modm(RS + 32, S);
 }
 
+void
+ED25519_FN(ed25519_sign) (const unsigned char *m, size_t mlen, const ed25519_secret_key sk, const ed25519_public_key pk, ed25519_signature RS) {
+	bignum256modm a;
+	hash_512bits extsk;
+
+	ed25519_extsk(extsk, sk);
+	expand256_modm(a, extsk, 32);
+	ed25519_sign_extsk(m, mlen, extsk, a, pk, RS);
+}
+
+/*
+	Expands sk for ed25519_sign_expanded so callers signing repeatedly with one key can keep the result
+*/
+
+void
+ED25519_FN(ed25519_secret_expand) (const ed25519_secret_key sk, ed25519_expanded_secret_key extsk) {
+	ed25519_extsk(extsk, sk);
+}
+
+void
+ED25519_FN(ed25519_sign_expanded) (const unsigned char *m, size_t mlen, const ed25519_expanded_secret_key extsk, const ed25519_public_key pk, ed25519_signature RS) {
+	bignum256modm a;
+
+	expand256_modm(a, extsk, 32);
+	ed25519_sign_extsk(m, mlen, extsk, a, pk, RS);
+}
+
+/*
+	Signs num messages with one key, the secret is expanded once for the whole batch
+*/
+
+void
+ED25519_FN(ed25519_sign_batch) (const unsigned char **m, size_t *mlen, const ed25519_secret_key sk, const ed25519_public_key pk, unsigned char **RS, size_t num) {
+	bignum256modm a;
+	hash_512bits extsk;
+	size_t i;
+
+	ed25519_extsk(extsk, sk);
+	expand256_modm(a, extsk, 32);
+	for (i = 0; i < num; i++)
+		ed25519_sign_extsk(m[i], mlen[i], extsk, a, pk, RS[i]);
+}
+
 int
 ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed25519_public_key pk, const ed25519_signature RS) {
 	ge25519 ALIGN(16) R, A;